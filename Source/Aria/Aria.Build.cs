@@ -15,7 +15,8 @@ public class Aria : ModuleRules
 			"InputCore",
 			"EnhancedInput",
 			"UMG",
-			"Niagara"
+			"Niagara",
+			"MassEntity"
 		});
 	}
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Animation/AriaAnimNotify.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Components/SkeletalMeshComponent.h"
+
+void UAriaAnimNotify::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::Notify(MeshComp, Animation, EventReference);
+
+	// editor previews and other meshes aren't owned by a character
+	if (const auto AriaCharacter = MeshComp ? Cast<AAriaCharacter>(MeshComp->GetOwner()) : nullptr)
+	{
+		AriaCharacter->GetAriaCharacterMovement()->HandleAnimEvent(Event);
+	}
+}
@@ -2,8 +2,7 @@
 
 #include "Animation/CrawlingAnimNotify.h"
 
-void UCrawlingAnimNotify::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+UCrawlingAnimNotify::UCrawlingAnimNotify()
 {
-	OnNotified.Broadcast();
-	Super::Notify(MeshComp, Animation, EventReference);
+	Event = EAriaAnimEvent::CrawlingFinished;
 }
@@ -2,8 +2,7 @@
 
 #include "Animation/DashAnimNotify.h"
 
-void UDashAnimNotify::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+UDashAnimNotify::UDashAnimNotify()
 {
-	OnNotified.Broadcast();
-	Super::Notify(MeshComp, Animation, EventReference);
+	Event = EAriaAnimEvent::DashFinished;
 }
@@ -2,8 +2,7 @@
 
 #include "Animation/FallingToRollAnimNotify.h"
 
-void UFallingToRollAnimNotify::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+UFallingToRollAnimNotify::UFallingToRollAnimNotify()
 {
-	OnNotified.Broadcast();
-	Super::Notify(MeshComp, Animation, EventReference);
+	Event = EAriaAnimEvent::FallingToRollFinished;
 }
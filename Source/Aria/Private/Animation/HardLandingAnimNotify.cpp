@@ -2,8 +2,7 @@
 
 #include "Animation/HardLandingAnimNotify.h"
 
-void UHardLandingAnimNotify::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+UHardLandingAnimNotify::UHardLandingAnimNotify()
 {
-	OnNotified.Broadcast();
-	Super::Notify(MeshComp, Animation, EventReference);
+	Event = EAriaAnimEvent::HardLandingFinished;
 }
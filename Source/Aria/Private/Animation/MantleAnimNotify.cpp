@@ -2,8 +2,7 @@
 
 #include "Animation/MantleAnimNotify.h"
 
-void UMantleAnimNotify::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+UMantleAnimNotify::UMantleAnimNotify()
 {
-	OnNotified.Broadcast();
-	Super::Notify(MeshComp, Animation, EventReference);
+	Event = EAriaAnimEvent::MantleFinished;
 }
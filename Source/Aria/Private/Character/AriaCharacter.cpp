@@ -4,6 +4,7 @@
 #include "DrawDebugHelpers.h"
 #include "Engine/LocalPlayer.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/ChildActorComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "EnhancedInputComponent.h"
@@ -14,6 +15,7 @@
 #include "Components/PostProcessComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Misc/Paths.h"
 
 DEFINE_LOG_CATEGORY(LogAriaCharacter);
 
@@ -26,6 +28,10 @@ AAriaCharacter::AAriaCharacter(const FObjectInitializer& ObjectInitializer)
 	bUseControllerRotationYaw = false;
 	bUseControllerRotationRoll = false;
 
+	// the movement component picks the update rate tier from its LOD
+	GetMesh()->bEnableUpdateRateOptimizations = true;
+	GetMesh()->OnAnimUpdateRateParamsCreated.BindUObject(this, &AAriaCharacter::OnAnimUpdateRateParamsCreated);
+
 	constexpr float TargetArmLength = 1000.f;
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>("CameraBoom");
 	CameraBoom->SetupAttachment(RootComponent);
@@ -52,13 +58,32 @@ AAriaCharacter::AAriaCharacter(const FObjectInitializer& ObjectInitializer)
 	PostProcessComponent->Settings = PostProcessSettings;
 }
 
-void AAriaCharacter::BeginPlay()
+void AAriaCharacter::PostInitializeComponents()
 {
-	Super::BeginPlay();
+	Super::PostInitializeComponents();
 
 	AriaCharacterMovement = Cast<UAriaCharacterMovement>(GetCharacterMovement());
 	check(AriaCharacterMovement);
-	
+	CameraBoomBaseLocation = CameraBoom->GetRelativeLocation();
+
+	// keep the ignore list up to date when child actors are respawned
+	ForEachComponent<UChildActorComponent>(false, [this](UChildActorComponent* ChildActorComponent)
+	{
+		ChildActorComponent->OnChildActorCreated().AddUObject(this, &AAriaCharacter::OnChildActorCreated);
+	});
+
+	QueryParams.bReturnPhysicalMaterial = true;
+	RefreshQueryParams();
+}
+
+void AAriaCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// the spring arm and its camera read the capsule, they have to see this frame's move
+	AriaCharacterMovement->AddCameraTickDependent(CameraBoom->PrimaryComponentTick);
+	AriaCharacterMovement->AddCameraTickDependent(FollowCamera->PrimaryComponentTick);
+
 	if (const auto* PlayerController = Cast<APlayerController>(Controller))
 	{
 		if (const auto Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
@@ -136,14 +161,70 @@ void AAriaCharacter::DashPressed()
 	AriaCharacterMovement->bWantsToDash = true;
 }
 
-FCollisionQueryParams AAriaCharacter::GetQueryParams() const
+// ReSharper disable once CppMemberFunctionMayBeConst
+void AAriaCharacter::RecordMovement(const FString& Filename)
+{
+	const FString RecordingFilename = Filename.IsEmpty() ? FPaths::ProjectSavedDir() / TEXT("MovementRecordings") / FDateTime::Now().ToString() + TEXT(".armr") : Filename;
+	AriaCharacterMovement->StartRecording(RecordingFilename);
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+void AAriaCharacter::StopRecordingMovement()
 {
-	TArray<TObjectPtr<AActor>> CharacterChildren;
-	GetAllChildActors(CharacterChildren);
+	AriaCharacterMovement->StopRecording();
+}
 
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActors(CharacterChildren);
+void AAriaCharacter::RefreshQueryParams()
+{
+	// the movement calls this once per tick, the ignore list is only rebuilt after a child actor was respawned
+	if (!bQueryParamsDirty)
+	{
+		return;
+	}
+
+	bQueryParamsDirty = false;
+	QueryParams.ClearIgnoredActors();
 	QueryParams.AddIgnoredActor(this);
+	AddIgnoredAttachedActors(this);
+}
 
+const FCollisionQueryParams& AAriaCharacter::GetQueryParams(const FName TraceTag, const TStatId& StatId)
+{
+	// name the shared params after the query so it shows up in the collision stats and the collision analyzer
+	QueryParams.TraceTag = TraceTag;
+	QueryParams.StatId = StatId;
 	return QueryParams;
 }
+
+void AAriaCharacter::SetVisualOffset(const FVector& WorldOffset)
+{
+	// moves the mesh and the camera off the capsule without touching the simulated state
+	const FVector LocalOffset = GetActorTransform().InverseTransformVectorNoScale(WorldOffset);
+	GetMesh()->SetRelativeLocation(GetBaseTranslationOffset() + LocalOffset);
+	CameraBoom->SetRelativeLocation(CameraBoomBaseLocation + LocalOffset);
+}
+
+void AAriaCharacter::OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params)
+{
+	// may run while the mesh registers, before the movement pointer is cached
+	if (const auto Movement = Cast<UAriaCharacterMovement>(GetCharacterMovement()))
+	{
+		Movement->ConfigureAnimationUpdateRate(Params);
+	}
+}
+
+void AAriaCharacter::AddIgnoredAttachedActors(const AActor* Actor)
+{
+	// child actors are attached to their component, so this covers them as well
+	Actor->ForEachAttachedActors([this](AActor* AttachedActor)
+	{
+		QueryParams.AddIgnoredActor(AttachedActor);
+		AddIgnoredAttachedActors(AttachedActor);
+		return true;
+	});
+}
+
+void AAriaCharacter::OnChildActorCreated(AActor* ChildActor)
+{
+	bQueryParamsDirty = true;
+}
@@ -3,20 +3,169 @@
 #include "Character/AriaCharacterMovement.h"
 #include "DrawDebugHelpers.h"
 #include "StaticMeshAttributes.h"
-#include "Animation/CrawlingAnimNotify.h"
-#include "Animation/DashAnimNotify.h"
-#include "Animation/FallingToRollAnimNotify.h"
-#include "Animation/HardLandingAnimNotify.h"
-#include "Animation/MantleAnimNotify.h"
 #include "Character/AriaCharacter.h"
+#include "Character/AriaTraversalRules.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "Curves/CurveFloat.h"
 #include "GameFramework/Character.h"
+#include "Interactable/TraversalVolume.h"
 #include "Kismet/GameplayStaticsTypes.h"
+#include "Manager/AriaMovementSubsystem.h"
+#include "Manager/MantleLedgeSubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "Utils/AriaStats.h"
 #include "Utils/VariableStorage.h"
 
 DEFINE_LOG_CATEGORY(LogAriaCharacterMovement);
 
+DECLARE_CYCLE_STAT(TEXT("Mode Transitions"), STAT_AriaUpdateModeTransitions, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Apply Probe Result"), STAT_AriaApplyProbeResult, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Prefetch Probes"), STAT_AriaPrefetchProbes, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Wall Slide"), STAT_AriaTryWallSlide, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Enter Slide"), STAT_AriaTryEnterSlide, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Exit Slide"), STAT_AriaTryExitSlide, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Rope Walking"), STAT_AriaTryRopeWalking, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Pushing"), STAT_AriaTryPushing, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Enter Crawling"), STAT_AriaTryEnterCrawling, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Exit Crawling"), STAT_AriaTryExitCrawling, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Mantle"), STAT_AriaTryMantle, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Climb Ladder"), STAT_AriaTryClimbLadder, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Dash"), STAT_AriaTryDash, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Try Ice Sliding"), STAT_AriaTryIceSliding, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Wall Slide"), STAT_AriaPhysWallSlide, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Slide"), STAT_AriaPhysSlide, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Rope Walking"), STAT_AriaPhysRopeWalking, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Pushing"), STAT_AriaPhysPushing, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Crawling"), STAT_AriaPhysCrawling, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Climb Ladder"), STAT_AriaPhysClimbLadder, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Ice Sliding"), STAT_AriaPhysIceSliding, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Phys Simulated Proxy"), STAT_AriaPhysSimulatedProxy, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Probe Forward"), STAT_AriaProbeForward, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Probe Down"), STAT_AriaProbeDown, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Probe Ledge"), STAT_AriaProbeLedge, STATGROUP_AriaMovement);
+
+namespace AriaModeTransitions
+{
+	// transitions in evaluation order, must match UAriaCharacterMovement::TransitionGuards
+	enum ETransition : uint8
+	{
+		WallSlide,
+		EnterSlide,
+		ExitSlide,
+		RopeWalking,
+		Pushing,
+		EnterCrawling,
+		ExitCrawling,
+		Mantle,
+		ClimbLadder,
+		Dash,
+		IceSliding,
+		Count
+	};
+
+	constexpr uint32 Bit(const ETransition Transition)
+	{
+		return 1u << Transition;
+	}
+
+	constexpr int32 StateIndex(const EMovementMode Mode, const uint8 CustomMode)
+	{
+		return Mode == MOVE_Custom ? MOVE_MAX + CustomMode : Mode;
+	}
+
+	constexpr int32 StateCount = MOVE_MAX + CMOVE_MAX;
+
+	// guards that don't check the mode, they fire from any mode their probes allow. A guard is left out of its own mode, where it changes nothing
+	constexpr uint32 AnyModeTransitions = Bit(RopeWalking) | Bit(Pushing) | Bit(ClimbLadder) | Bit(Dash) | Bit(IceSliding);
+	constexpr uint32 GroundTransitions = AnyModeTransitions | Bit(EnterSlide) | Bit(EnterCrawling);
+
+	// from-mode -> transitions whose guards can fire from it, MOVE_None never runs the guards
+	constexpr uint32 ReachableTransitions[StateCount] =
+	{
+		/* MOVE_None */ 0,
+		/* MOVE_Walking */ GroundTransitions,
+		/* MOVE_NavWalking */ GroundTransitions,
+		/* MOVE_Falling */ AnyModeTransitions | Bit(WallSlide) | Bit(Mantle),
+		/* MOVE_Swimming */ AnyModeTransitions,
+		/* MOVE_Flying */ AnyModeTransitions & ~Bit(ClimbLadder),
+		/* MOVE_Custom */ 0,
+		/* CMOVE_None */ AnyModeTransitions,
+		/* CMOVE_WallSliding */ AnyModeTransitions | Bit(Mantle),
+		/* CMOVE_RopeWalk */ AnyModeTransitions & ~Bit(RopeWalking),
+		/* CMOVE_Slide */ AnyModeTransitions | Bit(ExitSlide),
+		/* CMOVE_Pushing */ AnyModeTransitions & ~Bit(Pushing),
+		/* CMOVE_Crawling */ AnyModeTransitions | Bit(ExitCrawling),
+		/* CMOVE_ClimbLadder */ (AnyModeTransitions & ~Bit(ClimbLadder)) | Bit(Mantle),
+		/* CMOVE_IceSliding */ AnyModeTransitions & ~Bit(IceSliding),
+	};
+
+	static_assert(StateIndex(MOVE_Custom, CMOVE_IceSliding) == StateCount - 1, "Every custom movement mode needs a row in ReachableTransitions");
+
+	enum EProbe : uint8
+	{
+		ForwardProbe = 1 << 0,
+		DownProbe = 1 << 1,
+		LedgeProbe = 1 << 2,
+		FloorProbe = 1 << 3,
+	};
+
+	// transition -> probes its guard reads, traced ahead of time by the batched probe phase
+	constexpr uint8 TransitionProbes[Count] =
+	{
+		/* WallSlide */ ForwardProbe | DownProbe,
+		/* EnterSlide */ FloorProbe,
+		/* ExitSlide */ FloorProbe,
+		/* RopeWalking */ DownProbe,
+		/* Pushing */ ForwardProbe,
+		/* EnterCrawling */ FloorProbe,
+		/* ExitCrawling */ 0,
+		/* Mantle */ LedgeProbe,
+		/* ClimbLadder */ ForwardProbe | DownProbe,
+		/* Dash */ 0,
+		/* IceSliding */ FloorProbe,
+	};
+	static_assert(Count <= 32, "Transitions must fit into the reachable transitions mask");
+
+	// checks that can wait a frame when the scene query budget is spent
+	constexpr uint32 LowPriorityTransitions = Bit(Mantle) | Bit(ClimbLadder);
+
+	// guard names for the scene query budget log
+	const TCHAR* const TransitionNames[Count] =
+	{
+		TEXT("TryWallSlide"),
+		TEXT("TryEnterSlide"),
+		TEXT("TryExitSlide"),
+		TEXT("TryRopeWalking"),
+		TEXT("TryPushing"),
+		TEXT("TryEnterCrawling"),
+		TEXT("TryExitCrawling"),
+		TEXT("TryMantle"),
+		TEXT("TryClimbLadder"),
+		TEXT("TryDash"),
+		TEXT("TryIceSliding"),
+	};
+
+	const TCHAR* const PhysicsScope = TEXT("Physics");
+}
+
+const UAriaCharacterMovement::FTransitionGuard UAriaCharacterMovement::TransitionGuards[] =
+{
+	&UAriaCharacterMovement::TryWallSlide,
+	&UAriaCharacterMovement::TryEnterSlide,
+	&UAriaCharacterMovement::TryExitSlide,
+	&UAriaCharacterMovement::TryRopeWalking,
+	&UAriaCharacterMovement::TryPushing,
+	&UAriaCharacterMovement::TryEnterCrawling,
+	&UAriaCharacterMovement::TryExitCrawling,
+	&UAriaCharacterMovement::TryMantle,
+	&UAriaCharacterMovement::TryClimbLadder,
+	&UAriaCharacterMovement::TryDash,
+	&UAriaCharacterMovement::TryIceSliding,
+};
+
 UAriaCharacterMovement::UAriaCharacterMovement()
 {
 	RotationRate = FRotator(0.f, 3072.f, 0.f);
@@ -33,6 +182,10 @@ UAriaCharacterMovement::UAriaCharacterMovement()
 	// Crouch
 	MaxWalkSpeedCrouched = 200.f;
 	GetNavAgentPropertiesRef().bCanCrouch = true;
+
+	// Replication
+	SetNetworkMoveDataContainer(NetworkMoveDataContainer);
+	SetMoveResponseDataContainer(MoveResponseDataContainer);
 }
 
 void UAriaCharacterMovement::InitializeComponent()
@@ -42,196 +195,1647 @@ void UAriaCharacterMovement::InitializeComponent()
 	AriaCharacterOwner = Cast<AAriaCharacter>(GetOwner());
 	check(AriaCharacterOwner);
 
-	AriaCharacterOwner->LandedDelegate.AddDynamic(this, &UAriaCharacterMovement::OnLanded);
-	InitAnimations();
+	AriaCharacterOwner->LandedDelegate.AddDynamic(this, &UAriaCharacterMovement::OnLanded);
+	MantleQuery = MakeMantleQuery();
+}
+
+void UAriaCharacterMovement::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// after every kind of move, simulated proxies included, and before the mesh ticks the animation
+	PublishAnimationSnapshot();
+}
+
+void UAriaCharacterMovement::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FullLodMaxTimeStep = MaxSimulationTimeStep;
+	MovementSubsystem = GetWorld()->GetSubsystem<UAriaMovementSubsystem>();
+	if (MovementSubsystem)
+	{
+		MovementSubsystem->RegisterMovement(this);
+	}
+
+	// ends the traversal modes whose finish notify was skipped
+	USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+	if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+	{
+		AnimInstance->OnMontageEnded.AddDynamic(this, &UAriaCharacterMovement::OnMovementMontageEnded);
+	}
+
+	DefaultVisibilityBasedAnimTickOption = Mesh->VisibilityBasedAnimTickOption;
+	ApplyAnimationLod();
+}
+
+void UAriaCharacterMovement::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopRecording();
+	if (MovementSubsystem)
+	{
+		MovementSubsystem->UnregisterMovement(this);
+		MovementSubsystem = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UAriaCharacterMovement::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	// simulated proxies take their mode from replication, probing would only waste scene queries
+	if (IsSimulatedProxy())
+	{
+		Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+		return;
+	}
+
+	RecordTickInput(DeltaSeconds);
+	DashCooldownRemaining = FMath::Max(0.f, DashCooldownRemaining - DeltaSeconds);
+	AriaCharacterOwner->RefreshQueryParams();
+	ResetMoveSceneQueries();
+	ConsumePrefetchedProbes();
+
+	// throttled characters only look for new transitions every few ticks
+	if (MovementLod != EAriaMovementLod::Throttled || ++TransitionTickCounter % FMath::Max(ThrottledLodTransitionInterval, 1) == 0)
+	{
+		UpdateModeTransitions();
+	}
+
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+}
+
+void UAriaCharacterMovement::UpdateCharacterStateAfterMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateAfterMovement(DeltaSeconds);
+
+	const TSharedPtr<FRootMotionSource> RootMotion = GetRootMotionSourceByID(RootMotionSourceID);
+	if (RootMotion && RootMotion->Status.HasFlag(ERootMotionSourceStatusFlags::Finished))
+	{
+		RemoveRootMotionSourceByID(RootMotionSourceID);
+	}
+
+	// the replicated state carries the direction of this move
+	UpdateClimbDirection();
+	if (CharacterOwner->HasAuthority())
+	{
+		ReplicatedModeState = MakeReplicatedModeState();
+	}
+
+	// replayed moves are corrected by the next server update, not worth prefetching
+	if (bUseAsyncProbes && !CharacterOwner->bClientUpdating && !IsSimulatedProxy())
+	{
+		PrefetchProbes();
+	}
+
+	UpdateFixedStepInterpolation();
+	PublishCameraSnapshot();
+	RecordTickResult();
+}
+
+float UAriaCharacterMovement::GetMaxSpeed() const
+{
+	const float MaxSpeed = Super::GetMaxSpeed();
+	if (MovementMode != MOVE_Custom)
+	{
+		return MaxSpeed;
+	}
+
+	switch (CustomMovementMode)
+	{
+		case CMOVE_RopeWalk: return MaxRopeWalkingSpeed;
+		case CMOVE_Pushing: return MaxPushingSpeed;
+		case CMOVE_Crawling: return MaxCrawlingSpeed;
+		case CMOVE_IceSliding: return MaxIceSlidingSpeed;
+		default: return MaxSpeed;
+	}
+}
+
+float UAriaCharacterMovement::GetSpeed() const
+{
+	return Velocity.Length();
+}
+
+bool UAriaCharacterMovement::IsWalk() const
+{
+	if (!IsWalking() || FMath::IsNearlyZero(GetSpeed()))
+	{
+		return false;
+	}
+
+	if (IsCrouching() || IsSliding() || IsRopeWalking() || IsPushing() || IsCrawling())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool UAriaCharacterMovement::CanAttemptJump() const
+{
+	return Super::CanAttemptJump() || IsWallSliding();
+}
+
+bool UAriaCharacterMovement::DoJump(bool bReplayingMoves)
+{
+	const bool bIsWallSliding = IsWallSliding();
+	if (Super::DoJump(bReplayingMoves))
+	{
+		if (bIsWallSliding)
+		{
+			const FHitResult& WallHitResult = ProbeForward();
+			if (IsProbeHitWithin(WallHitResult, GetWallSlideWallDistance()))
+			{
+				Velocity += WallHitResult.Normal * WallJumpOffForce;
+			}
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void UAriaCharacterMovement::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+	ARIA_MOVEMENT_CSV_COUNT(ModeTransitions, 1);
+
+	if (IsSimulatedProxy())
+	{
+		ApplySimulatedCapsuleSize();
+	}
+
+	// a custom mode starts its fixed steps from the current state
+	if (MovementMode == MOVE_Custom && PreviousMovementMode != MOVE_Custom)
+	{
+		FixedStepAccumulator = 0.f;
+		FixedStepPreviousLocation = UpdatedComponent->GetComponentLocation();
+	}
+}
+
+void UAriaCharacterMovement::PhysCustom(float deltaTime, int32 Iterations)
+{
+	Super::PhysCustom(deltaTime, Iterations);
+
+	if (IsSimulatedProxy())
+	{
+		PhysSimulatedProxy(deltaTime);
+		return;
+	}
+
+	if (IsFixedTimeStepActive())
+	{
+		PhysFixedTimeStep(deltaTime, Iterations);
+		return;
+	}
+
+	PhysCustomMode(deltaTime, Iterations);
+}
+
+void UAriaCharacterMovement::PhysCustomMode(const float DeltaTime, const int32 Iterations)
+{
+	switch (CustomMovementMode)
+	{
+		case CMOVE_WallSliding:
+			PhysWallSlide(DeltaTime, Iterations);
+			break;
+		case CMOVE_Slide:
+			PhysSlide(DeltaTime, Iterations);
+			break;
+		case CMOVE_RopeWalk:
+			PhysRopeWalking(DeltaTime, Iterations);
+			break;
+		case CMOVE_Pushing:
+			PhysPushing(DeltaTime, Iterations);
+			break;
+		case CMOVE_Crawling:
+			PhysCrawling(DeltaTime, Iterations);
+			break;
+		case CMOVE_ClimbLadder:
+			PhysClimbLadder(DeltaTime, Iterations);
+			break;
+		case CMOVE_IceSliding:
+			PhysIceSliding(DeltaTime, Iterations);
+			break;
+		default:
+			UE_LOG(LogAriaCharacterMovement, Error, TEXT("Invalid Movement Mode"))
+	}
+}
+
+#pragma region "Network Prediction"
+void FSavedMove_Aria::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToMove = false;
+	bSavedWantsToSlide = false;
+	bSavedWantsToCrawling = false;
+	bSavedWantsToDash = false;
+	bSavedIsDashInProgress = false;
+	SavedDashCooldownRemaining = 0.f;
+}
+
+uint8 FSavedMove_Aria::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+	Result |= bSavedWantsToMove ? FLAG_Custom_0 : 0;
+	Result |= bSavedWantsToSlide ? FLAG_Custom_1 : 0;
+	Result |= bSavedWantsToCrawling ? FLAG_Custom_2 : 0;
+	Result |= bSavedWantsToDash ? FLAG_Custom_3 : 0;
+	return Result;
+}
+
+bool FSavedMove_Aria::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, const float MaxDelta) const
+{
+	// differing intents are already rejected through the compressed flags
+	const FSavedMove_Aria* NewAriaMove = static_cast<const FSavedMove_Aria*>(NewMove.Get());
+	if (bSavedIsDashInProgress != NewAriaMove->bSavedIsDashInProgress)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Aria::CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation)
+{
+	Super::CombineWith(OldMove, InCharacter, PC, OldStartLocation);
+
+	// the combined move starts where the old move started
+	const FSavedMove_Aria* OldAriaMove = static_cast<const FSavedMove_Aria*>(OldMove);
+	bSavedIsDashInProgress = OldAriaMove->bSavedIsDashInProgress;
+	SavedDashCooldownRemaining = OldAriaMove->SavedDashCooldownRemaining;
+
+	if (const auto Movement = Cast<UAriaCharacterMovement>(InCharacter->GetCharacterMovement()))
+	{
+		Movement->bIsDashInProgress = bSavedIsDashInProgress;
+		Movement->DashCooldownRemaining = SavedDashCooldownRemaining;
+	}
+}
+
+void FSavedMove_Aria::SetMoveFor(ACharacter* C, const float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const auto Movement = Cast<UAriaCharacterMovement>(C->GetCharacterMovement()))
+	{
+		bSavedWantsToMove = Movement->bWantsToMove;
+		bSavedWantsToSlide = Movement->bWantsToSlide;
+		bSavedWantsToCrawling = Movement->bWantsToCrawling;
+		bSavedWantsToDash = Movement->bWantsToDash;
+		bSavedIsDashInProgress = Movement->bIsDashInProgress;
+		SavedDashCooldownRemaining = Movement->DashCooldownRemaining;
+	}
+}
+
+void FSavedMove_Aria::PostUpdate(ACharacter* C, const EPostUpdateMode PostUpdateMode)
+{
+	Super::PostUpdate(C, PostUpdateMode);
+
+	if (PostUpdateMode != PostUpdate_Record)
+	{
+		return;
+	}
+
+	if (const auto Movement = Cast<UAriaCharacterMovement>(C->GetCharacterMovement()))
+	{
+		SavedModeState = Movement->MakeReplicatedModeState();
+	}
+}
+
+FNetworkPredictionData_Client_Aria::FNetworkPredictionData_Client_Aria(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Aria::AllocateNewMove()
+{
+	return MakeShared<FSavedMove_Aria>();
+}
+
+FNetworkPredictionData_Client* UAriaCharacterMovement::GetPredictionData_Client() const
+{
+	check(PawnOwner != nullptr);
+
+	if (!ClientPredictionData)
+	{
+		UAriaCharacterMovement* MutableThis = const_cast<UAriaCharacterMovement*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Aria(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UAriaCharacterMovement::UpdateFromCompressedFlags(const uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToMove = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	bWantsToSlide = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+	bWantsToCrawling = (Flags & FSavedMove_Character::FLAG_Custom_2) != 0;
+	bWantsToDash = (Flags & FSavedMove_Character::FLAG_Custom_3) != 0;
+}
+
+bool UAriaCharacterMovement::ClientUpdatePositionAfterServerUpdate()
+{
+	// replayed flags overwrite the intents, keep the live input for the next move
+	const bool bRealWantsToMove = bWantsToMove;
+	const bool bRealWantsToSlide = bWantsToSlide;
+	const bool bRealWantsToCrawling = bWantsToCrawling;
+	const bool bRealWantsToDash = bWantsToDash;
+
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	bWantsToMove = bRealWantsToMove;
+	bWantsToSlide = bRealWantsToSlide;
+	bWantsToCrawling = bRealWantsToCrawling;
+	bWantsToDash = bRealWantsToDash;
+	return bResult;
+}
+
+void UAriaCharacterMovement::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	// the saved moves replay from the server traversal state, otherwise the client ends them in its own state again
+	if (!MoveResponse.IsGoodMove())
+	{
+		ApplyReplicatedModeState(static_cast<const FAriaMoveResponseDataContainer&>(MoveResponse).ModeState);
+	}
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+#pragma endregion
+
+#pragma region "Replication"
+bool FAriaReplicatedModeState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	Ar << SlidingTime;
+	Ar << DashCooldown;
+
+	// ladder direction shifted to 0..2
+	uint32 Direction = ClimbDirection + 1;
+	Ar.SerializeInt(Direction, 3);
+	ClimbDirection = static_cast<int8>(Direction) - 1;
+
+	uint8 bDashInProgress = bIsDashInProgress;
+	uint8 bMantleTarget = bHasMantleTarget;
+	Ar.SerializeBits(&bDashInProgress, 1);
+	Ar.SerializeBits(&bMantleTarget, 1);
+	bIsDashInProgress = bDashInProgress != 0;
+	bHasMantleTarget = bMantleTarget != 0;
+
+	if (bHasMantleTarget)
+	{
+		MantleTarget.NetSerialize(Ar, Map, bOutSuccess);
+	}
+
+	return true;
+}
+
+bool FAriaReplicatedModeState::operator==(const FAriaReplicatedModeState& Other) const
+{
+	return SlidingTime == Other.SlidingTime
+		&& ClimbDirection == Other.ClimbDirection
+		&& DashCooldown == Other.DashCooldown
+		&& bIsDashInProgress == Other.bIsDashInProgress
+		&& bHasMantleTarget == Other.bHasMantleTarget
+		&& (!bHasMantleTarget || MantleTarget == Other.MantleTarget);
+}
+
+bool FAriaReplicatedModeState::MatchesSimulation(const FAriaReplicatedModeState& Other) const
+{
+	return FMath::Abs(SlidingTime - Other.SlidingTime) <= 1
+		&& FMath::Abs(DashCooldown - Other.DashCooldown) <= 1
+		&& bIsDashInProgress == Other.bIsDashInProgress
+		&& bHasMantleTarget == Other.bHasMantleTarget
+		&& (!bHasMantleTarget || FVector::DistSquared(MantleTarget, Other.MantleTarget) <= 1.f);
+}
+
+uint8 FAriaReplicatedModeState::QuantizeFraction(const float Value, const float Range)
+{
+	return Range > 0.f ? static_cast<uint8>(FMath::RoundToInt(FMath::Clamp(Value / Range, 0.f, 1.f) * MAX_uint8)) : 0;
+}
+
+float FAriaReplicatedModeState::DequantizeFraction(const uint8 Value, const float Range)
+{
+	return Value * Range / MAX_uint8;
+}
+
+void FAriaNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, const ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	ModeState = static_cast<const FSavedMove_Aria&>(ClientMove).SavedModeState;
+}
+
+bool FAriaNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, const ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// old moves are only replayed for their position, the server never verifies them
+	if (MoveType != ENetworkMoveType::OldMove)
+	{
+		bool bModeStateSuccess = true;
+		ModeState.NetSerialize(Ar, PackageMap, bModeStateSuccess);
+	}
+
+	return !Ar.IsError();
+}
+
+FAriaNetworkMoveDataContainer::FAriaNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
+
+void FAriaMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	ModeState = static_cast<const UAriaCharacterMovement&>(CharacterMovement).MakeReplicatedModeState();
+}
+
+bool FAriaMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+	{
+		return false;
+	}
+
+	// a good move acknowledges the client state, only corrections carry the server state
+	if (!IsGoodMove())
+	{
+		bool bModeStateSuccess = true;
+		ModeState.NetSerialize(Ar, PackageMap, bModeStateSuccess);
+	}
+
+	return !Ar.IsError();
+}
+
+void UAriaCharacterMovement::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// the owning client simulates the state itself and is corrected through its moves
+	DOREPLIFETIME_CONDITION(UAriaCharacterMovement, ReplicatedModeState, COND_SimulatedOnly);
+}
+
+FAriaReplicatedModeState UAriaCharacterMovement::MakeReplicatedModeState() const
+{
+	FAriaReplicatedModeState State;
+	State.SlidingTime = IsSliding() ? FAriaReplicatedModeState::QuantizeFraction(SlidingTime, MaxSlidingSeconds) : 0;
+	State.ClimbDirection = static_cast<int8>(FMath::Sign(LastClimbDirection));
+	State.DashCooldown = FAriaReplicatedModeState::QuantizeFraction(DashCooldownRemaining, DashCooldown);
+	State.bIsDashInProgress = bIsDashInProgress;
+
+	if (RootMotionSource && GetRootMotionSourceByID(RootMotionSourceID))
+	{
+		State.bHasMantleTarget = true;
+		State.MantleTarget = RootMotionSource->TargetLocation;
+	}
+
+	return State;
+}
+
+void UAriaCharacterMovement::OnRep_ModeState()
+{
+	ApplyReplicatedModeState(ReplicatedModeState);
+}
+
+void UAriaCharacterMovement::ApplyReplicatedModeState(const FAriaReplicatedModeState& State)
+{
+	SlidingTime = FAriaReplicatedModeState::DequantizeFraction(State.SlidingTime, MaxSlidingSeconds);
+	LastClimbDirection = State.ClimbDirection;
+	DashCooldownRemaining = FAriaReplicatedModeState::DequantizeFraction(State.DashCooldown, DashCooldown);
+	bIsDashInProgress = State.bIsDashInProgress;
+}
+
+bool UAriaCharacterMovement::ServerCheckClientError(const float ClientTimeStamp, const float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, const FName ClientBaseBoneName, const uint8 ClientMovementMode)
+{
+	if (Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode))
+	{
+		return true;
+	}
+
+	// correct the client when it ended the move in a different traversal state, the correction carries the server state
+	const FAriaNetworkMoveData* MoveData = static_cast<const FAriaNetworkMoveData*>(GetCurrentNetworkMoveData());
+	return MoveData && !MoveData->ModeState.MatchesSimulation(MakeReplicatedModeState());
+}
+#pragma endregion
+
+#pragma region "LOD"
+EAriaMovementLod UAriaCharacterMovement::EvaluateMovementLod(const float ViewDistance, const bool bIsVisible) const
+{
+	// players always simulate fully
+	if (!bEnableMovementLod || !CharacterOwner || CharacterOwner->IsPlayerControlled())
+	{
+		return EAriaMovementLod::Full;
+	}
+
+	// promote as soon as the character is closer than its tier, demote only past the hysteresis margin
+	const float LodDistances[] = { 0.f, ReducedLodDistance, ThrottledLodDistance, DormantLodDistance };
+	constexpr int32 MaxLod = static_cast<int32>(EAriaMovementLod::Dormant);
+	int32 Lod = static_cast<int32>(MovementLod);
+	while (Lod > 0 && ViewDistance < LodDistances[Lod])
+	{
+		Lod--;
+	}
+
+	while (Lod < MaxLod && ViewDistance >= LodDistances[Lod + 1] + LodHysteresisDistance)
+	{
+		Lod++;
+	}
+
+	// visible characters keep checking transitions every tick
+	if (bIsVisible)
+	{
+		Lod = FMath::Min(Lod, static_cast<int32>(EAriaMovementLod::Reduced));
+	}
+
+	// a dormant character has to rest on the ground, it would hang in the air otherwise, and must have nothing left to move
+	if (Lod == MaxLod && (!IsMovingOnGround() || !Velocity.IsNearlyZero() || HasPendingMovement()))
+	{
+		Lod = static_cast<int32>(EAriaMovementLod::Throttled);
+	}
+
+	return static_cast<EAriaMovementLod>(Lod);
+}
+
+bool UAriaCharacterMovement::HasPendingMovement() const
+{
+	if (!Acceleration.IsNearlyZero() || bHasRequestedVelocity || !PendingLaunchVelocity.IsZero() || !PendingImpulseToApply.IsZero() || !PendingForceToApply.IsZero())
+	{
+		return true;
+	}
+
+	return bWantsToSlide || bWantsToDash || (CharacterOwner && (CharacterOwner->bPressedJump || !CharacterOwner->GetPendingMovementInputVector().IsNearlyZero()));
+}
+
+void UAriaCharacterMovement::AddInputVector(const FVector WorldVector, const bool bForce)
+{
+	Super::AddInputVector(WorldVector, bForce);
+
+	// dormant characters don't tick, wake them up instead of letting the input pile up until the next LOD update
+	if (MovementLod == EAriaMovementLod::Dormant && !WorldVector.IsNearlyZero())
+	{
+		SetMovementLod(EAriaMovementLod::Throttled);
+	}
+}
+
+void UAriaCharacterMovement::RequestDirectMove(const FVector& MoveVelocity, const bool bForceMaxSpeed)
+{
+	Super::RequestDirectMove(MoveVelocity, bForceMaxSpeed);
+
+	// path following moves through the requested velocity, it is only consumed by a tick
+	if (MovementLod == EAriaMovementLod::Dormant && !MoveVelocity.IsNearlyZero())
+	{
+		SetMovementLod(EAriaMovementLod::Throttled);
+	}
+}
+
+void UAriaCharacterMovement::SetMovementLod(const EAriaMovementLod Lod)
+{
+	if (Lod == MovementLod)
+	{
+		return;
+	}
+
+	MovementLod = Lod;
+	switch (Lod)
+	{
+		case EAriaMovementLod::Full:
+			LodTickInterval = 0.f;
+			MaxSimulationTimeStep = FullLodMaxTimeStep;
+			break;
+		case EAriaMovementLod::Reduced:
+			LodTickInterval = 1.f / ReducedLodTickRate;
+			MaxSimulationTimeStep = ReducedLodMaxTimeStep;
+			break;
+		case EAriaMovementLod::Throttled:
+			LodTickInterval = 1.f / ThrottledLodTickRate;
+			MaxSimulationTimeStep = ReducedLodMaxTimeStep;
+			break;
+		case EAriaMovementLod::Dormant:
+			break;
+	}
+
+	ApplyComponentTickSettings();
+	ApplyAnimationLod();
+}
+
+void UAriaCharacterMovement::SetTickBatched(const bool bBatched)
+{
+	bIsTickBatched = bBatched;
+	ApplyComponentTickSettings();
+}
+
+void UAriaCharacterMovement::ApplyComponentTickSettings()
+{
+	// the movement subsystem applies the LOD tick rate to batched components itself
+	SetComponentTickInterval(bIsTickBatched ? 0.f : LodTickInterval);
+	SetComponentTickEnabled(!bIsTickBatched && MovementLod != EAriaMovementLod::Dormant);
+}
+#pragma endregion
+
+#pragma region "Fixed Time Step"
+bool UAriaCharacterMovement::IsFixedTimeStepActive() const
+{
+	// networked moves are replayed with their own delta times, the accumulator isn't part of the saved move
+	return bUseFixedTimeStep && FixedTimeStepRate > 0.f && GetNetMode() == NM_Standalone;
+}
+
+void UAriaCharacterMovement::PhysFixedTimeStep(const float DeltaTime, const int32 Iterations)
+{
+	const float FixedStep = 1.f / FixedTimeStepRate;
+	const uint8 Mode = CustomMovementMode;
+	FixedStepAccumulator += DeltaTime;
+
+	int32 Steps = 0;
+	while (FixedStepAccumulator >= FixedStep && Steps < MaxFixedStepsPerTick)
+	{
+		FixedStepPreviousLocation = UpdatedComponent->GetComponentLocation();
+		FixedStepAccumulator -= FixedStep;
+		Steps++;
+		PhysCustomMode(FixedStep, Iterations);
+
+		// the mode handed the rest of the step to another physics function
+		if (MovementMode != MOVE_Custom || CustomMovementMode != Mode)
+		{
+			FixedStepAccumulator = 0.f;
+			return;
+		}
+	}
+
+	// drop the time a frame spike left behind instead of catching up over the next ticks
+	if (Steps == MaxFixedStepsPerTick)
+	{
+		FixedStepAccumulator = FMath::Min(FixedStepAccumulator, FixedStep * 0.99f);
+	}
+}
+
+void UAriaCharacterMovement::UpdateFixedStepInterpolation()
+{
+	// draw the mesh and camera between the last two fixed steps, the unsimulated time behind the simulation
+	if (IsFixedTimeStepActive() && bInterpolateFixedTimeStep && MovementMode == MOVE_Custom && !IsSimulatedProxy())
+	{
+		const float Alpha = FMath::Clamp(FixedStepAccumulator * FixedTimeStepRate, 0.f, 1.f);
+		FixedStepVisualOffset = (FixedStepPreviousLocation - UpdatedComponent->GetComponentLocation()) * (1.f - Alpha);
+		AriaCharacterOwner->SetVisualOffset(FixedStepVisualOffset);
+		bHasFixedStepVisualOffset = true;
+	}
+	else if (bHasFixedStepVisualOffset)
+	{
+		FixedStepVisualOffset = FVector::ZeroVector;
+		AriaCharacterOwner->SetVisualOffset(FixedStepVisualOffset);
+		bHasFixedStepVisualOffset = false;
+	}
+}
+#pragma endregion
+
+#pragma region "Animation"
+void UAriaCharacterMovement::HandleAnimEvent(const EAriaAnimEvent Event)
+{
+	PendingAnimEvents &= ~(1 << static_cast<uint8>(Event));
+	switch (Event)
+	{
+		case EAriaAnimEvent::HardLandingFinished:
+			OnHardLandingAnimFinished();
+			break;
+		case EAriaAnimEvent::FallingToRollFinished:
+			OnFallingToRollAnimFinished();
+			break;
+		case EAriaAnimEvent::CrawlingFinished:
+			OnCrawlingAnimFinished();
+			break;
+		case EAriaAnimEvent::MantleFinished:
+			OnMantleAnimFinished();
+			break;
+		case EAriaAnimEvent::DashFinished:
+			OnDashAnimFinished();
+			break;
+	}
+}
+
+void UAriaCharacterMovement::UpdateClimbDirection()
+{
+	// remember last climb direction to play Idle Up or Down animation, simulated proxies receive it with the mode state
+	if (!IsClimbLadder() || IsSimulatedProxy())
+	{
+		return;
+	}
+
+	// the climb velocity follows the move input, unlike the last input vector it is simulated on the server too
+	const float ClimbInput = MaxClimbLadderSpeed > 0.f ? Velocity.Z / MaxClimbLadderSpeed : 0.f;
+	if (FMath::IsNearlyZero(LastClimbDirection) || (!FMath::IsNearlyZero(ClimbInput) && ClimbInput != LastClimbDirection))
+	{
+		LastClimbDirection = ClimbInput;
+	}
+}
+
+void UAriaCharacterMovement::PublishAnimationSnapshot()
+{
+	FAriaAnimationSnapshot Snapshot;
+	Snapshot.MovementMode = MovementMode;
+	Snapshot.CustomMovementMode = static_cast<ECustomMovementMode>(CustomMovementMode);
+	Snapshot.Speed = GetSpeed();
+	Snapshot.ClimbLadderDirection = LastClimbDirection;
+	Snapshot.bIsWalk = IsWalk();
+	Snapshot.bIsFalling = IsFalling();
+	Snapshot.bIsCrouching = IsCrouching();
+	Snapshot.bIsWallSliding = IsWallSliding();
+	Snapshot.bIsSliding = IsSliding();
+	Snapshot.bIsRopeWalking = IsRopeWalking();
+	Snapshot.bIsPushing = IsPushing();
+	Snapshot.bIsCrawling = IsCrawling();
+	Snapshot.bIsClimbLadder = IsClimbLadder();
+	Snapshot.bIsIceSliding = IsIceSliding();
+	Snapshot.bIsDashInProgress = bIsDashInProgress;
+	AnimationSnapshot = Snapshot;
+}
+#pragma endregion
+
+#pragma region "Animation LOD"
+void UAriaCharacterMovement::ConfigureAnimationUpdateRate(FAnimUpdateRateParameters* Params) const
+{
+	if (!bEnableAnimationLod)
+	{
+		return;
+	}
+
+	// the update rate follows the mesh LOD, which the movement LOD tier bounds from below
+	Params->bShouldUseLodMap = true;
+	Params->bInterpolateSkippedFrames = true;
+	Params->LODToFrameSkipMap.Reset();
+	for (int32 Lod = 0; Lod < AnimationFrameSkipPerLod.Num(); Lod++)
+	{
+		Params->LODToFrameSkipMap.Add(Lod, AnimationFrameSkipPerLod[Lod]);
+	}
+}
+
+void UAriaCharacterMovement::ApplyAnimationLod()
+{
+	USkeletalMeshComponent* Mesh = CharacterOwner ? CharacterOwner->GetMesh() : nullptr;
+	if (!Mesh)
+	{
+		return;
+	}
+
+	// the min LOD override only applies while the flag is set
+	Mesh->bEnableUpdateRateOptimizations = bEnableAnimationLod;
+	Mesh->bOverrideMinLod = bEnableAnimationLod && MovementLod != EAriaMovementLod::Full;
+	if (!bEnableAnimationLod)
+	{
+		return;
+	}
+
+	switch (MovementLod)
+	{
+		case EAriaMovementLod::Full:
+			Mesh->OverrideMinLOD(0);
+			break;
+		case EAriaMovementLod::Reduced:
+			Mesh->OverrideMinLOD(ReducedAnimationMinLod);
+			break;
+		case EAriaMovementLod::Throttled:
+		case EAriaMovementLod::Dormant:
+			Mesh->OverrideMinLOD(ThrottledAnimationMinLod);
+			break;
+	}
+
+	// montages keep ticking off screen, their notifies end the dash, crawl and mantle modes
+	Mesh->VisibilityBasedAnimTickOption = MovementLod == EAriaMovementLod::Full ? DefaultVisibilityBasedAnimTickOption : EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+}
+
+bool UAriaCharacterMovement::GetMontageEvent(const UAnimMontage* Montage, EAriaAnimEvent& OutEvent) const
+{
+	if (!Montage)
+	{
+		return false;
+	}
+
+	if (Montage == HardLandingAnim)
+	{
+		OutEvent = EAriaAnimEvent::HardLandingFinished;
+	}
+	else if (Montage == FallingToRollAnim)
+	{
+		OutEvent = EAriaAnimEvent::FallingToRollFinished;
+	}
+	else if (Montage == CrawlingAnim)
+	{
+		OutEvent = EAriaAnimEvent::CrawlingFinished;
+	}
+	else if (Montage == MantleAnim)
+	{
+		OutEvent = EAriaAnimEvent::MantleFinished;
+	}
+	else if (Montage == GroundedDashAnim)
+	{
+		OutEvent = EAriaAnimEvent::DashFinished;
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void UAriaCharacterMovement::OnMovementMontageEnded(UAnimMontage* Montage, bool bInterrupted)
+{
+	// end events are queued, a replay of the same montage may already be running
+	const UAnimInstance* AnimInstance = CharacterOwner->GetMesh()->GetAnimInstance();
+	if (AnimInstance && AnimInstance->Montage_IsPlaying(Montage))
+	{
+		return;
+	}
+
+	// the notify was skipped with the evaluation or cut by a montage that isn't a movement one
+	if (EAriaAnimEvent Event; GetMontageEvent(Montage, Event) && (PendingAnimEvents & (1 << static_cast<uint8>(Event))))
+	{
+		UE_LOG(LogAriaCharacterMovement, Verbose, TEXT("%s finished %s without its notify"), *GetNameSafe(CharacterOwner), *GetNameSafe(Montage));
+		HandleAnimEvent(Event);
+	}
+}
+#pragma endregion
+
+#pragma region "Camera"
+void UAriaCharacterMovement::PublishCameraSnapshot()
+{
+	// only reads what this tick's physics already found, the walking floor or the floor cached by the custom modes
+	const bool bHasFreshFloor = FloorCache.Frame == GFrameCounter;
+	const FFindFloorResult& Floor = IsMovingOnGround() ? CurrentFloor : FloorCache.Floor;
+	const bool bIsGrounded = (IsMovingOnGround() || (bHasFreshFloor && MovementMode == MOVE_Custom)) && Floor.IsWalkableFloor();
+
+	CameraSnapshot.Frame = GFrameCounter;
+	CameraSnapshot.Location = GetCameraTargetLocation();
+	CameraSnapshot.Velocity = Velocity;
+	CameraSnapshot.bIsGrounded = bIsGrounded;
+	CameraSnapshot.MovementMode = MovementMode;
+	CameraSnapshot.CustomMovementMode = CustomMovementMode;
+
+	// keep the last floor height while airborne
+	if (bIsGrounded)
+	{
+		CameraSnapshot.FloorZ = Floor.HitResult.ImpactPoint.Z;
+	}
+}
+
+FVector UAriaCharacterMovement::GetCameraTargetLocation() const
+{
+	return UpdatedComponent->GetComponentLocation() + FixedStepVisualOffset;
+}
+
+void UAriaCharacterMovement::AddCameraTickDependent(FTickFunction& TickFunction)
+{
+	// both ways the movement can tick, prerequisites that don't tick this frame are skipped
+	TickFunction.AddPrerequisite(this, PrimaryComponentTick);
+	if (MovementSubsystem)
+	{
+		MovementSubsystem->AddBatchTickDependent(TickFunction);
+	}
+}
+
+void UAriaCharacterMovement::RemoveCameraTickDependent(FTickFunction& TickFunction)
+{
+	TickFunction.RemovePrerequisite(this, PrimaryComponentTick);
+	if (MovementSubsystem)
+	{
+		MovementSubsystem->RemoveBatchTickDependent(TickFunction);
+	}
+}
+#pragma endregion
+
+#pragma region "Recording"
+void UAriaCharacterMovement::StartRecording(const FString& Filename)
+{
+	StopRecording();
+	if (IsSimulatedProxy() || !UpdatedComponent)
+	{
+		return;
+	}
+
+	FAriaMovementRecordHeader Header;
+	Header.MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+	Header.CharacterClass = CharacterOwner->GetClass()->GetPathName();
+	Header.Location = UpdatedComponent->GetComponentLocation();
+	Header.Rotation = UpdatedComponent->GetComponentRotation();
+	Header.Velocity = Velocity;
+	Header.MovementMode = MovementMode;
+	Header.CustomMovementMode = CustomMovementMode;
+	Header.SlidingTime = SlidingTime;
+	Header.bIsDashInProgress = bIsDashInProgress;
+	Header.DashCooldownRemaining = DashCooldownRemaining;
+	Header.CapsuleRadius = CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+	Header.CapsuleHalfHeight = CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+
+	Recorder = MakeUnique<FAriaMovementRecordWriter>();
+	if (!Recorder->Open(Filename, Header))
+	{
+		UE_LOG(LogAriaCharacterMovement, Warning, TEXT("Failed to open movement recording %s"), *Filename);
+		Recorder.Reset();
+		return;
+	}
+
+	UE_LOG(LogAriaCharacterMovement, Log, TEXT("Recording %s movement to %s"), *GetNameSafe(CharacterOwner), *Filename);
+}
+
+void UAriaCharacterMovement::StopRecording()
+{
+	if (!Recorder)
+	{
+		return;
+	}
+
+	Recorder->Close();
+	UE_LOG(LogAriaCharacterMovement, Log, TEXT("Recorded %d movement ticks of %s"), Recorder->NumFrames(), *GetNameSafe(CharacterOwner));
+	Recorder.Reset();
+}
+
+void UAriaCharacterMovement::RestoreRecordedState(const FAriaMovementRecordHeader& Header)
+{
+	SetMovementMode(static_cast<EMovementMode>(Header.MovementMode), Header.CustomMovementMode);
+	Velocity = Header.Velocity;
+	SlidingTime = Header.SlidingTime;
+	bIsDashInProgress = Header.bIsDashInProgress;
+	DashCooldownRemaining = Header.DashCooldownRemaining;
+
+	// the recorded location is the center of the recorded capsule, a slide, crawl or push starts with its own size
+	CharacterOwner->GetCapsuleComponent()->SetCapsuleSize(Header.CapsuleRadius, Header.CapsuleHalfHeight);
+	InvalidateProbe();
+}
+
+void UAriaCharacterMovement::RecordTickInput(const float DeltaSeconds)
+{
+	// replayed moves were already recorded when they were first simulated
+	if (!Recorder || CharacterOwner->bClientUpdating)
+	{
+		return;
+	}
+
+	using EIntent = FAriaMovementRecordFrame::EIntent;
+	RecordFrame.DeltaTime = DeltaSeconds;
+	RecordFrame.InputVector = FVector3f(GetLastInputVector());
+	RecordFrame.Intents = static_cast<uint8>((bWantsToMove ? EIntent::Move : 0)
+		| (bWantsToSlide ? EIntent::Slide : 0)
+		| (bWantsToCrawling ? EIntent::Crawl : 0)
+		| (bWantsToDash ? EIntent::Dash : 0)
+		| (CharacterOwner->bPressedJump ? EIntent::Jump : 0)
+		| (bWantsToCrouch ? EIntent::Crouch : 0));
+}
+
+void UAriaCharacterMovement::RecordTickResult()
+{
+	if (!Recorder || CharacterOwner->bClientUpdating || IsSimulatedProxy())
+	{
+		return;
+	}
+
+	RecordFrame.MovementMode = MovementMode;
+	RecordFrame.CustomMovementMode = CustomMovementMode;
+	RecordFrame.Location = UpdatedComponent->GetComponentLocation();
+	RecordFrame.Velocity = Velocity;
+	Recorder->AddFrame(RecordFrame);
+}
+#pragma endregion
+
+#pragma region "Simulated Proxy"
+void UAriaCharacterMovement::PhysSimulatedProxy(const float DeltaTime)
+{
+	ARIA_MOVEMENT_SCOPE(PhysSimulatedProxy);
+
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	// follow the replicated velocity until the next server position is smoothed in, sliding along what it runs into
+	const FVector Delta = Velocity * DeltaTime;
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+	if (Hit.IsValidBlockingHit())
+	{
+		SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, false);
+	}
+}
+
+void UAriaCharacterMovement::ApplySimulatedCapsuleSize()
+{
+	// the server already checked the resize for encroachment, apply the size of the replicated mode as is
+	UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	const UCapsuleComponent* DefaultCapsule = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>()->GetCapsuleComponent();
+	const float DefaultHalfHeight = DefaultCapsule->GetUnscaledCapsuleHalfHeight();
+	float Radius = DefaultCapsule->GetUnscaledCapsuleRadius();
+	float HalfHeight = DefaultHalfHeight;
+	if (IsSliding() || IsCrawling())
+	{
+		HalfHeight = FMath::Max3(0.f, Radius, SlideCollisionHalfHeight);
+	}
+	else if (IsPushing())
+	{
+		Radius = PushingCapsuleRadius;
+	}
+
+	const float OldHalfHeight = Capsule->GetUnscaledCapsuleHalfHeight();
+	if (Capsule->GetUnscaledCapsuleRadius() == Radius && OldHalfHeight == HalfHeight)
+	{
+		return;
+	}
+
+	Capsule->SetCapsuleSize(Radius, HalfHeight);
+	InvalidateProbe();
+	AdjustProxyCapsuleSize();
+
+	if (OldHalfHeight == HalfHeight)
+	{
+		return;
+	}
+
+	// keep the capsule base in place without letting the mesh smoothing see the jump
+	const float ComponentScale = Capsule->GetShapeScale();
+	const float ScaledHalfHeightAdjust = (OldHalfHeight - HalfHeight) * ComponentScale;
+	if (bCrouchMaintainsBaseLocation)
+	{
+		UpdatedComponent->MoveComponent(FVector(0.f, 0.f, -ScaledHalfHeightAdjust), UpdatedComponent->GetComponentQuat(), false, nullptr, MOVECOMP_NoFlags, ETeleportType::TeleportPhysics);
+		if (FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character())
+		{
+			ClientData->MeshTranslationOffset -= FVector(0.f, 0.f, ScaledHalfHeightAdjust);
+			ClientData->OriginalMeshTranslationOffset = ClientData->MeshTranslationOffset;
+		}
+	}
+
+	// crouch events take the change from the default size
+	if (HalfHeight < OldHalfHeight)
+	{
+		const float HalfHeightAdjust = DefaultHalfHeight - HalfHeight;
+		CharacterOwner->OnStartCrouch(HalfHeightAdjust, HalfHeightAdjust * ComponentScale);
+	}
+	else
+	{
+		const float HalfHeightAdjust = DefaultHalfHeight - OldHalfHeight;
+		CharacterOwner->OnEndCrouch(HalfHeightAdjust, HalfHeightAdjust * ComponentScale);
+	}
+}
+#pragma endregion
+
+#pragma region "Traversal Volumes"
+void UAriaCharacterMovement::EnterTraversalVolume(const ATraversalVolume* Volume)
+{
+	// a volume is counted once, however often its overlap is reported
+	if (TraversalVolumes.Contains(Volume))
+	{
+		return;
+	}
+
+	TraversalVolumes.Add(Volume);
+	const auto SurfaceKinds = static_cast<EAriaSurfaceKind>(Volume->SurfaceKinds);
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(TraversalVolumeCounts); Index++)
+	{
+		if (EnumHasAnyFlags(SurfaceKinds, static_cast<EAriaSurfaceKind>(1 << Index)))
+		{
+			TraversalVolumeCounts[Index]++;
+		}
+	}
+}
+
+void UAriaCharacterMovement::ExitTraversalVolume(const ATraversalVolume* Volume)
+{
+	// the end of play and the end overlap of the same volume both release it, only the first one counts
+	if (TraversalVolumes.Remove(Volume) == 0)
+	{
+		return;
+	}
+
+	const auto SurfaceKinds = static_cast<EAriaSurfaceKind>(Volume->SurfaceKinds);
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(TraversalVolumeCounts); Index++)
+	{
+		if (EnumHasAnyFlags(SurfaceKinds, static_cast<EAriaSurfaceKind>(1 << Index)) && TraversalVolumeCounts[Index] > 0)
+		{
+			TraversalVolumeCounts[Index]--;
+		}
+	}
+}
+
+bool UAriaCharacterMovement::IsInsideTraversalVolume(const EAriaSurfaceKind SurfaceKind) const
+{
+	if (!bRequireTraversalVolumes)
+	{
+		return true;
+	}
+
+	// volumes can overlap, so every surface kind counts the volumes the character is inside of
+	return TraversalVolumeCounts[FMath::CountTrailingZeros(static_cast<uint32>(SurfaceKind))] > 0;
+}
+#pragma endregion
+
+#pragma region "Mode Transitions"
+void UAriaCharacterMovement::UpdateModeTransitions()
+{
+	ARIA_MOVEMENT_SCOPE(UpdateModeTransitions);
+
+	static_assert(UE_ARRAY_COUNT(TransitionGuards) == AriaModeTransitions::Count, "Every transition needs a guard");
+
+	// nothing can change while a grounded character stands still without any intent
+	if (IsAtRest())
+	{
+		return;
+	}
+
+	using namespace AriaModeTransitions;
+	uint32 Candidates = GetReachableTransitions();
+	while (Candidates)
+	{
+		const uint32 Transition = FMath::CountTrailingZeros(Candidates);
+		if (((1u << Transition) & LowPriorityTransitions) && CanDeferTransitions() && IsOverSceneQueryBudget())
+		{
+			// the guard runs again next frame
+			UE_LOG(LogAriaCharacterMovement, VeryVerbose, TEXT("%s deferred %s, scene query budget spent"), *GetNameSafe(CharacterOwner), TransitionNames[Transition]);
+		}
+		else
+		{
+			SceneQueryScope = TransitionNames[Transition];
+			(this->*TransitionGuards[Transition])();
+		}
+
+		// a guard may have changed the mode, continue with the later transitions reachable from the new one
+		Candidates = GetReachableTransitions() & ~((2u << Transition) - 1);
+	}
+
+	SceneQueryScope = PhysicsScope;
+}
+
+uint32 UAriaCharacterMovement::GetReachableTransitions() const
+{
+	if (MovementMode == MOVE_Custom && CustomMovementMode >= CMOVE_MAX)
+	{
+		return 0;
+	}
+
+	return AriaModeTransitions::ReachableTransitions[AriaModeTransitions::StateIndex(MovementMode, CustomMovementMode)];
+}
+
+bool UAriaCharacterMovement::MakeProbeRequest(FAriaProbeRequest& OutRequest) const
+{
+	// a prefetch requested last frame already covers the probes of this move
+	if (!UpdatedComponent || IsAtRest() || IsSimulatedProxy() || ProbePrefetch.Frame + 1 == GFrameCounter)
+	{
+		return false;
+	}
+
+	// skip the guards the traversal volumes will reject anyway
+	using namespace AriaModeTransitions;
+	uint32 Candidates = GetReachableTransitions();
+	Candidates &= IsInsideTraversalVolume(EAriaSurfaceKind::Rope) ? ~0u : ~Bit(RopeWalking);
+	Candidates &= IsInsideTraversalVolume(EAriaSurfaceKind::Ladder) ? ~0u : ~Bit(ClimbLadder);
+	Candidates &= IsInsideTraversalVolume(EAriaSurfaceKind::Ice) ? ~0u : ~Bit(IceSliding);
+
+	uint8 Probes = 0;
+	while (Candidates)
+	{
+		Probes |= TransitionProbes[FMath::CountTrailingZeros(Candidates)];
+		Candidates &= Candidates - 1;
+	}
+
+	if (!Probes)
+	{
+		return false;
+	}
+
+	OutRequest.Location = UpdatedComponent->GetComponentLocation();
+	OutRequest.Rotation = UpdatedComponent->GetComponentQuat();
+	OutRequest.Probes = Probes;
+	OutRequest.ForwardLength = GetForwardProbeLength();
+	OutRequest.DownLength = GetDownProbeLength();
+	OutRequest.LedgeLength = GetLedgeProbeLength();
+	OutRequest.QueryParams = &AriaCharacterOwner->GetQueryParams(SCENE_QUERY_STAT(AriaProbeBatch));
+	return true;
+}
+
+void UAriaCharacterMovement::TraceProbeRequest(const FAriaProbeRequest& Request, FAriaProbeResult& OutResult) const
+{
+	// runs on a worker thread, it only reads the world and writes the result
+	using namespace AriaModeTransitions;
+	const UWorld* World = GetWorld();
+	const FVector Forward = Request.Rotation.GetForwardVector();
+	if (Request.Probes & ForwardProbe)
+	{
+		OutResult.ForwardHit = FHitResult();
+		World->LineTraceSingleByProfile(OutResult.ForwardHit, Request.Location, Request.Location + Forward * Request.ForwardLength, "BlockAll", *Request.QueryParams);
+	}
+
+	if (Request.Probes & DownProbe)
+	{
+		OutResult.DownHit = FHitResult();
+		World->LineTraceSingleByProfile(OutResult.DownHit, Request.Location, Request.Location + FVector::DownVector * Request.DownLength, "BlockAll", *Request.QueryParams);
+	}
+
+	if (Request.Probes & LedgeProbe)
+	{
+		const FVector Start = Request.Location + FVector::UpVector * MantleUpOffsetDistance;
+		OutResult.LedgeHit = FHitResult();
+		World->LineTraceSingleByProfile(OutResult.LedgeHit, Start, Start + Forward.GetSafeNormal2D() * Request.LedgeLength, "BlockAll", *Request.QueryParams);
+	}
+}
+
+void UAriaCharacterMovement::ApplyProbeResult(const FAriaProbeRequest& Request, const FAriaProbeResult& Result)
+{
+	ARIA_MOVEMENT_SCOPE(ApplyProbeResult);
+
+	// the hits only hold while the capsule is where they were traced from
+	using namespace AriaModeTransitions;
+	RefreshProbe();
+	if (!Probe.Location.Equals(Request.Location, 0.f) || !Probe.Rotation.Equals(Request.Rotation, 0.f))
+	{
+		return;
+	}
+
+	SceneQueryScope = TEXT("ProbeBatch");
+	if (Request.Probes & ForwardProbe)
+	{
+		CountSceneQuery();
+		Probe.ForwardHit = Result.ForwardHit;
+		Probe.ForwardLength = Request.ForwardLength;
+		Probe.ForwardSurface = ClassifySurface(Probe.ForwardHit);
+		Probe.bHasForwardHit = true;
+	}
+
+	if (Request.Probes & DownProbe)
+	{
+		CountSceneQuery();
+		Probe.DownHit = Result.DownHit;
+		Probe.DownLength = Request.DownLength;
+		Probe.DownSurface = ClassifySurface(Probe.DownHit);
+		Probe.bHasDownHit = true;
+	}
+
+	if (Request.Probes & LedgeProbe)
+	{
+		CountSceneQuery();
+		Probe.LedgeHit = Result.LedgeHit;
+		Probe.LedgeLength = Request.LedgeLength;
+		Probe.bHasLedgeHit = true;
+	}
+
+	// the engine floor search writes the component's floor check flags, it stays on the game thread
+	if (Request.Probes & FloorProbe)
+	{
+		GetCachedFloor();
+	}
+
+	SceneQueryScope = PhysicsScope;
+}
+
+bool UAriaCharacterMovement::IsAtRest() const
+{
+	if (MovementMode != MOVE_Walking || bWantsToSlide || bWantsToCrawling || bWantsToDash)
+	{
+		return false;
+	}
+
+	return Velocity.IsNearlyZero() && Acceleration.IsNearlyZero();
+}
+#pragma endregion
+
+#pragma region "Probe"
+int32 UAriaCharacterMovement::GetSceneQueryCount() const
+{
+	return SceneQueryFrame == GFrameCounter ? SceneQueryCount : 0;
+}
+
+const FHitResult& UAriaCharacterMovement::ProbeForward(const float Length) const
+{
+	RefreshProbe();
+	if (!Probe.bHasForwardHit || Length > Probe.ForwardLength)
+	{
+		ARIA_MOVEMENT_SCOPE(ProbeForward);
+
+		// trace once with the longest forward distance any predicate asks for
+		Probe.ForwardLength = FMath::Max(Length, GetForwardProbeLength());
+		Probe.ForwardHit = FHitResult();
+		TraceLine(Probe.ForwardHit, Probe.Location, Probe.Location + Probe.Rotation.GetForwardVector() * Probe.ForwardLength, SCENE_QUERY_STAT(AriaProbeForward));
+		Probe.ForwardSurface = ClassifySurface(Probe.ForwardHit);
+		Probe.bHasForwardHit = true;
+	}
+
+	return Probe.ForwardHit;
+}
+
+const FHitResult& UAriaCharacterMovement::ProbeDown(const float Length) const
+{
+	RefreshProbe();
+	if (!Probe.bHasDownHit || Length > Probe.DownLength)
+	{
+		ARIA_MOVEMENT_SCOPE(ProbeDown);
+
+		// trace once with the longest downward distance any predicate asks for
+		Probe.DownLength = FMath::Max(Length, GetDownProbeLength());
+		Probe.DownHit = FHitResult();
+		TraceLine(Probe.DownHit, Probe.Location, Probe.Location + FVector::DownVector * Probe.DownLength, SCENE_QUERY_STAT(AriaProbeDown));
+		Probe.DownSurface = ClassifySurface(Probe.DownHit);
+		Probe.bHasDownHit = true;
+	}
+
+	return Probe.DownHit;
+}
+
+const FFindFloorResult& UAriaCharacterMovement::GetCachedFloor() const
+{
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	if (FloorCache.Frame != GFrameCounter || !FloorCache.Location.Equals(Location, 0.f))
+	{
+		// FindFloor stores its result in the cache
+		FFindFloorResult FloorResult;
+		FindFloor(Location, FloorResult, false);
+	}
+
+	return FloorCache.Floor;
+}
+
+void UAriaCharacterMovement::FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult) const
+{
+	CountSceneQuery();
+	Super::FindFloor(CapsuleLocation, OutFloorResult, bCanUseCachedLocation, DownwardSweepResult);
+
+	// remember floors found at the capsule location, including the ones found by the walking and falling physics
+	if (UpdatedComponent && CapsuleLocation.Equals(UpdatedComponent->GetComponentLocation(), 0.f))
+	{
+		FloorCache.Frame = GFrameCounter;
+		FloorCache.Location = CapsuleLocation;
+		FloorCache.Floor = OutFloorResult;
+		FloorCache.Surface = ClassifySurface(OutFloorResult.HitResult);
+	}
+}
+
+const FHitResult& UAriaCharacterMovement::ProbeLedge(const float Length) const
+{
+	RefreshProbe();
+	if (!Probe.bHasLedgeHit || Length > Probe.LedgeLength)
+	{
+		ARIA_MOVEMENT_SCOPE(ProbeLedge);
+
+		const FVector Start = Probe.Location + FVector::UpVector * MantleUpOffsetDistance;
+		Probe.LedgeLength = FMath::Max(Length, GetLedgeProbeLength());
+		Probe.LedgeHit = FHitResult();
+		TraceLine(Probe.LedgeHit, Start, Start + Probe.Rotation.GetForwardVector().GetSafeNormal2D() * Probe.LedgeLength, SCENE_QUERY_STAT(AriaProbeLedge));
+		Probe.bHasLedgeHit = true;
+	}
+
+	return Probe.LedgeHit;
+}
+
+void UAriaCharacterMovement::RefreshProbe() const
+{
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+	if (Probe.Frame == GFrameCounter && Probe.Location.Equals(Location, 0.f) && Probe.Rotation.Equals(Rotation, 0.f))
+	{
+		return;
+	}
+
+	// the capsule has moved or a new frame has started, all probes have to be traced again
+	Probe = FAriaMovementProbe();
+	Probe.Frame = GFrameCounter;
+	Probe.Location = Location;
+	Probe.Rotation = Rotation;
+}
+
+void UAriaCharacterMovement::InvalidateProbe()
+{
+	Probe.Frame = 0;
+	FloorCache.Frame = 0;
+}
+
+float UAriaCharacterMovement::GetForwardProbeLength() const
+{
+	return FMath::Max3(GetWallSlideWallDistance(), ForwardDistanceToCheckLadder, ForwardSearchPushingLength);
+}
+
+float UAriaCharacterMovement::GetDownProbeLength() const
+{
+	return FMath::Max3(GetWallSlideFloorDistance(), GetCapsuleHalfHeight() + 5.f, GetCapsuleRadius() + MinHeightToClimbLadder);
+}
+
+float UAriaCharacterMovement::GetLedgeProbeLength() const
+{
+	return FMath::Max(GetCapsuleRadius() + 30.f, MaxFrontMantleCheckDistance);
+}
+
+void UAriaCharacterMovement::PrefetchProbes()
+{
+	ARIA_MOVEMENT_SCOPE(PrefetchProbes);
+
+	// the next move checks its transitions before moving, so it starts where this one ended. Trace from there on the physics worker threads
+	const FCollisionQueryParams& QueryParams = AriaCharacterOwner->GetQueryParams(SCENE_QUERY_STAT(AriaProbePrefetch));
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+	const FVector LedgeStart = Location + FVector::UpVector * MantleUpOffsetDistance;
+
+	ProbePrefetch.Frame = GFrameCounter;
+	ProbePrefetch.Location = Location;
+	ProbePrefetch.Rotation = Rotation;
+	ProbePrefetch.ForwardLength = GetForwardProbeLength();
+	ProbePrefetch.DownLength = GetDownProbeLength();
+	ProbePrefetch.LedgeLength = GetLedgeProbeLength();
+	ProbePrefetch.ForwardHandle = GetWorld()->AsyncLineTraceByProfile(EAsyncTraceType::Single, Location, Location + Rotation.GetForwardVector() * ProbePrefetch.ForwardLength, "BlockAll", QueryParams);
+	ProbePrefetch.DownHandle = GetWorld()->AsyncLineTraceByProfile(EAsyncTraceType::Single, Location, Location + FVector::DownVector * ProbePrefetch.DownLength, "BlockAll", QueryParams);
+	ProbePrefetch.LedgeHandle = GetWorld()->AsyncLineTraceByProfile(EAsyncTraceType::Single, LedgeStart, LedgeStart + Rotation.GetForwardVector().GetSafeNormal2D() * ProbePrefetch.LedgeLength, "BlockAll", QueryParams);
+}
+
+void UAriaCharacterMovement::ConsumePrefetchedProbes()
+{
+	if (ProbePrefetch.Frame == 0)
+	{
+		return;
+	}
+
+	// async results are only available the frame after they were requested
+	const FAriaProbePrefetch Prefetch = ProbePrefetch;
+	ProbePrefetch = FAriaProbePrefetch();
+	if (Prefetch.Frame + 1 != GFrameCounter)
+	{
+		return;
+	}
+
+	// fall back to synchronous probes if the capsule was moved in between, by its base or a teleport
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+	if (!Location.Equals(Prefetch.Location, AsyncProbeLocationTolerance) || !Rotation.Equals(Prefetch.Rotation))
+	{
+		return;
+	}
+
+	if (Prefetch.ForwardLength != GetForwardProbeLength() || Prefetch.DownLength != GetDownProbeLength() || Prefetch.LedgeLength != GetLedgeProbeLength())
+	{
+		return;
+	}
+
+	RefreshProbe();
+	Probe.bHasForwardHit = ConsumePrefetchedHit(Prefetch.ForwardHandle, Probe.ForwardHit);
+	Probe.ForwardLength = Prefetch.ForwardLength;
+	Probe.ForwardSurface = ClassifySurface(Probe.ForwardHit);
+	Probe.bHasDownHit = ConsumePrefetchedHit(Prefetch.DownHandle, Probe.DownHit);
+	Probe.DownLength = Prefetch.DownLength;
+	Probe.DownSurface = ClassifySurface(Probe.DownHit);
+	Probe.bHasLedgeHit = ConsumePrefetchedHit(Prefetch.LedgeHandle, Probe.LedgeHit);
+	Probe.LedgeLength = Prefetch.LedgeLength;
 }
 
-void UAriaCharacterMovement::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+bool UAriaCharacterMovement::ConsumePrefetchedHit(const FTraceHandle& TraceHandle, FHitResult& OutHit) const
 {
-	// Wall Sliding
-	TryWallSlide();
+	FTraceDatum TraceDatum;
+	if (!GetWorld()->QueryTraceData(TraceHandle, TraceDatum))
+	{
+		return false;
+	}
+
+	OutHit = TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult();
+	return true;
+}
 
-	// Sliding
-	if (FFindFloorResult FloorHit; IsMovingOnGround() && bWantsToSlide && CanSlide(FloorHit))
+EAriaSurfaceKind UAriaCharacterMovement::ClassifySurface(const FHitResult& HitResult) const
+{
+	if (!HitResult.bBlockingHit)
 	{
-		EnterSlide();
+		return EAriaSurfaceKind::None;
 	}
 
-	if (IsSliding() && !bWantsToSlide)
+	bool bHasSurfaceMaterial;
+	const EAriaSurfaceKind SurfaceKind = UAriaPhysicalMaterial::GetSurfaceKinds(HitResult, bHasSurfaceMaterial);
+	if (bHasSurfaceMaterial || !bClassifySurfacesByTag)
 	{
-		ExitSlide();
+		return SurfaceKind;
 	}
 
-	// Rope Walking
-	TryRopeWalking();
+	return UAriaPhysicalMaterial::GetTaggedSurfaceKinds(HitResult.GetActor(), RopeTag, ClimbLadderTag, IceTag, MovableTag);
+}
 
-	// Push Objects
-	TryPushing();
+bool UAriaCharacterMovement::IsProbeHitWithin(const FHitResult& HitResult, const float Length)
+{
+	// the first blocking hit of a longer trace is the first blocking hit of any shorter one
+	return HitResult.bBlockingHit && HitResult.Distance <= Length;
+}
 
-	// Crawling
-	if (FFindFloorResult FloorHit; IsMovingOnGround() && bWantsToCrawling && CanCrawling(FloorHit))
+void UAriaCharacterMovement::CountSceneQuery() const
+{
+	if (SceneQueryFrame != GFrameCounter)
 	{
-		EnterCrawling();
+		SceneQueryFrame = GFrameCounter;
+		SceneQueryCount = 0;
 	}
-	
-	if (IsCrawling() && !bWantsToCrawling)
+
+	SceneQueryCount++;
+	MoveSceneQueryCount++;
+	ARIA_MOVEMENT_CSV_COUNT(SceneQueries, 1);
+	if (MovementSubsystem)
 	{
-		ExitCrawling();
+		MovementSubsystem->AddSceneQuery();
 	}
 
-	// Mantle
-	TryMantle();
-
-	// Climb Ladder
-	TryClimbLadder();
-
-	// Dash
-	TryDash();
-
-	// Ice Sliding
-	TryIceSliding();
-
-	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
-}
-
-void UAriaCharacterMovement::UpdateCharacterStateAfterMovement(float DeltaSeconds)
-{
-	Super::UpdateCharacterStateAfterMovement(DeltaSeconds);
+	// remember which predicates spent the queries, in the order they ran
+	if (SceneQueryChain.IsEmpty() || SceneQueryChain.Last().Key != SceneQueryScope)
+	{
+		SceneQueryChain.Emplace(SceneQueryScope, 0);
+	}
 
-	const TSharedPtr<FRootMotionSource> RootMotion = GetRootMotionSourceByID(RootMotionSourceID);
-	if (RootMotion && RootMotion->Status.HasFlag(ERootMotionSourceStatusFlags::Finished))
+	SceneQueryChain.Last().Value++;
+	if (!bSceneQueryBudgetReported && SceneQueryBudget > 0 && MoveSceneQueryCount > SceneQueryBudget)
 	{
-		RemoveRootMotionSourceByID(RootMotionSourceID);
+		bSceneQueryBudgetReported = true;
+		ReportSceneQueryBudget();
 	}
 }
 
-float UAriaCharacterMovement::GetMaxSpeed() const
+void UAriaCharacterMovement::ReportSceneQueryBudget() const
 {
-	const float MaxSpeed = Super::GetMaxSpeed();
-	if (MovementMode != MOVE_Custom)
+	FString Chain;
+	for (const TPair<const TCHAR*, int32>& Link : SceneQueryChain)
 	{
-		return MaxSpeed;
+		Chain += FString::Printf(TEXT("%s%s x%d"), Chain.IsEmpty() ? TEXT("") : TEXT(" > "), Link.Key, Link.Value);
 	}
 
-	switch (CustomMovementMode)
-	{
-		case CMOVE_RopeWalk: return MaxRopeWalkingSpeed;
-		case CMOVE_Pushing: return MaxPushingSpeed;
-		case CMOVE_Crawling: return MaxCrawlingSpeed;
-		case CMOVE_IceSliding: return MaxIceSlidingSpeed;
-		default: return MaxSpeed;
-	}
+	UE_LOG(LogAriaCharacterMovement, Warning, TEXT("%s exceeded its budget of %d scene queries in one move: %s"), *GetNameSafe(CharacterOwner), SceneQueryBudget, *Chain);
 }
 
-float UAriaCharacterMovement::GetSpeed() const
+void UAriaCharacterMovement::ResetMoveSceneQueries()
 {
-	return Velocity.Length();
+	// a frame may run several moves, a server one per client move and a client every replayed one
+	MoveSceneQueryCount = 0;
+	SceneQueryChain.Reset();
+	bSceneQueryBudgetReported = false;
 }
 
-bool UAriaCharacterMovement::IsWalk() const
+bool UAriaCharacterMovement::IsOverSceneQueryBudget() const
 {
-	if (!IsWalking() || FMath::IsNearlyZero(GetSpeed()))
+	if (SceneQueryBudget > 0 && MoveSceneQueryCount >= SceneQueryBudget)
 	{
-		return false;
+		return true;
 	}
 
-	if (IsCrouching() || IsSliding() || IsRopeWalking() || IsPushing() || IsCrawling())
+	const int32 WorldShare = MovementSubsystem ? MovementSubsystem->GetWorldSceneQueryShare() : 0;
+	return WorldShare > 0 && GetSceneQueryCount() >= WorldShare;
+}
+
+bool UAriaCharacterMovement::CanDeferTransitions() const
+{
+	if (!bDeferLowPriorityTransitions || bClientUpdating || !CharacterOwner)
 	{
 		return false;
 	}
 
-	return true;
-}
-
-bool UAriaCharacterMovement::CanAttemptJump() const
-{
-	return Super::CanAttemptJump() || IsWallSliding();
+	// the authority of a character without a predicting client, a deferred guard on either end of a predicted move diverges
+	return CharacterOwner->GetLocalRole() == ROLE_Authority && CharacterOwner->GetRemoteRole() != ROLE_AutonomousProxy;
 }
 
-bool UAriaCharacterMovement::DoJump(bool bReplayingMoves)
+bool UAriaCharacterMovement::MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, const bool bSweep, FHitResult* OutHit, const ETeleportType Teleport)
 {
-	const bool bIsWallSliding = IsWallSliding();
-	if (Super::DoJump(bReplayingMoves))
+	if (bSweep && !Delta.IsZero())
 	{
-		if (bIsWallSliding)
-		{
-			FHitResult HitResult;
-			FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
-			const FVector Start = UpdatedComponent->GetComponentLocation();
-			GetWorld()->LineTraceSingleByProfile(HitResult, Start, EndForwardVector(Start), "BlockAll", QueryParams);
-			Velocity += HitResult.Normal * WallJumpOffForce;
-		}
-
-		return true;
+		CountSceneQuery();
 	}
 
-	return false;
+	return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
 }
 
-void UAriaCharacterMovement::PhysCustom(float deltaTime, int32 Iterations)
+bool UAriaCharacterMovement::TraceLine(FHitResult& OutHit, const FVector& Start, const FVector& End, const FName TraceTag, const TStatId& StatId) const
 {
-	Super::PhysCustom(deltaTime, Iterations);
+	CountSceneQuery();
+	return GetWorld()->LineTraceSingleByProfile(OutHit, Start, End, "BlockAll", AriaCharacterOwner->GetQueryParams(TraceTag, StatId));
+}
 
-	switch (CustomMovementMode)
-	{
-		case CMOVE_WallSliding:
-			PhysWallSlide(deltaTime, Iterations);
-			break;
-		case CMOVE_Slide:
-			PhysSlide(deltaTime, Iterations);
-			break;
-		case CMOVE_RopeWalk:
-			PhysRopeWalking(deltaTime, Iterations);
-			break;
-		case CMOVE_Pushing:
-			PhysPushing(deltaTime, Iterations);
-			break;
-		case CMOVE_Crawling:
-			PhysCrawling(deltaTime, Iterations);
-			break;
-		case CMOVE_ClimbLadder:
-			PhysClimbLadder(deltaTime, Iterations);
-			break;
-		case CMOVE_IceSliding:
-			PhysIceSliding(deltaTime, Iterations);
-			break;
-		default:
-			UE_LOG(LogAriaCharacterMovement, Error, TEXT("Invalid Movement Mode"))
-	}
+bool UAriaCharacterMovement::OverlapCapsule(const FVector& Location, const FCollisionShape& CollisionShape, const FName TraceTag, const TStatId& StatId) const
+{
+	CountSceneQuery();
+	return GetWorld()->OverlapAnyTestByProfile(Location, FQuat::Identity, "BlockAll", CollisionShape, AriaCharacterOwner->GetQueryParams(TraceTag, StatId));
 }
+#pragma endregion
 
 #pragma region "Wall Slide"
 void UAriaCharacterMovement::TryWallSlide()
 {
-	if (!IsFalling())
-	{
-		return;
-	}
+	ARIA_MOVEMENT_SCOPE(TryWallSlide);
 
-	FHitResult FloorHitResult, WallHitResult;
-	FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
-	const FVector Start = UpdatedComponent->GetComponentLocation();
-	
 	// exit if the height to floor is smaller than MinHeightToSlide
-	if (GetWorld()->LineTraceSingleByProfile(FloorHitResult, Start, EndDownVector(Start), "BlockAll", QueryParams))
+	if (IsProbeHitWithin(ProbeDown(), GetWallSlideFloorDistance()))
 	{
 		return;
 	}
 
 	// exit if the character is not close to the wall
-	GetWorld()->LineTraceSingleByProfile(WallHitResult, Start, EndForwardVector(Start), "BlockAll", QueryParams);
-	if (!WallHitResult.IsValidBlockingHit() || (Velocity | WallHitResult.Normal) >= 0)
+	const FHitResult& WallHitResult = ProbeForward();
+	if (!IsProbeHitWithin(WallHitResult, GetWallSlideWallDistance()) || !WallHitResult.IsValidBlockingHit() || (Velocity | WallHitResult.Normal) >= 0)
 	{
 		return;
 	}
 
 	// exit if the actor is ladder
-	TObjectPtr<AActor> WallActor = WallHitResult.GetActor();
-	if (WallActor && WallActor->ActorHasTag(ClimbLadderTag))
+	if (EnumHasAnyFlags(Probe.ForwardSurface, EAriaSurfaceKind::Ladder))
 	{
 		return;
 	}
-	
+
 	// all is good, go to wall slide
 	Velocity = FVector::VectorPlaneProject(Velocity, WallHitResult.Normal);
 	Velocity.Z = FMath::Clamp(Velocity.Z, 0, MaxVerticalWallSlideSpeed);
@@ -240,6 +1844,8 @@ void UAriaCharacterMovement::TryWallSlide()
 
 void UAriaCharacterMovement::PhysWallSlide(float DeltaTime, int32 Iterations)
 {
+	ARIA_MOVEMENT_SCOPE(PhysWallSlide);
+
 	if (DeltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -257,17 +1863,15 @@ void UAriaCharacterMovement::PhysWallSlide(float DeltaTime, int32 Iterations)
 	while (CanPerformFrameTickMovement(RemainingTime, Iterations))
 	{
 		Iterations++;
+		ARIA_MOVEMENT_CSV_COUNT(CustomPhysIterations, 1);
 		bJustTeleported = false;
 		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
 		RemainingTime -= TimeTick;
 
 		// exit if the character is grounded
-		FHitResult WallHitResult;
 		const FVector OldLocation = UpdatedComponent->GetComponentLocation();
-		FVector Start = UpdatedComponent->GetComponentLocation();
-		FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
-		GetWorld()->LineTraceSingleByProfile(WallHitResult, Start, EndForwardVector(Start), "BlockAll", QueryParams);
-		if (!WallHitResult.IsValidBlockingHit())
+		const FHitResult& WallHitResult = ProbeForward();
+		if (!IsProbeHitWithin(WallHitResult, GetWallSlideWallDistance()) || !WallHitResult.IsValidBlockingHit())
 		{
 			SetMovementMode(MOVE_Falling);
 			StartNewPhysics(RemainingTime, Iterations);
@@ -279,10 +1883,7 @@ void UAriaCharacterMovement::PhysWallSlide(float DeltaTime, int32 Iterations)
 
 		// apply acceleration
 		CalcVelocity(TimeTick, 0.f, false, GetMaxBrakingDeceleration());
-		Velocity = FVector::VectorPlaneProject(Velocity, WallHitResult.Normal);
-		const bool bVelocityUp = Velocity.Z > 0.f;
-		const float TangentAccel = Acceleration.GetSafeNormal2D() | Velocity.GetSafeNormal2D();
-		Velocity.Z += GetGravityZ() * WallSlideGravityCurve->GetFloatValue(bVelocityUp ? 0.f : TangentAccel) * TimeTick;
+		Velocity = FAriaTraversalRules::GetWallSlideVelocity(Velocity, WallHitResult.Normal, Acceleration, GetGravityZ(), WallSlideGravityCurve, TimeTick);
 
 		// compute move parameters
 		FHitResult HitResult;
@@ -297,44 +1898,62 @@ void UAriaCharacterMovement::PhysWallSlide(float DeltaTime, int32 Iterations)
 	}
 
 	// check again if the slide conditions are met
-	FHitResult FloorHitResult, WallHitResult;
-	FVector Start = UpdatedComponent->GetComponentLocation();
-	FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
-	GetWorld()->LineTraceSingleByProfile(WallHitResult, Start, EndForwardVector(Start), "BlockAll", QueryParams);
-	GetWorld()->LineTraceSingleByProfile(FloorHitResult, Start, EndDownVector(Start), "BlockAll", QueryParams);
-	if (FloorHitResult.IsValidBlockingHit() || !WallHitResult.IsValidBlockingHit())
+	const FHitResult& WallHitResult = ProbeForward();
+	const FHitResult& FloorHitResult = ProbeDown();
+	const bool bHasWall = IsProbeHitWithin(WallHitResult, GetWallSlideWallDistance()) && WallHitResult.IsValidBlockingHit();
+	const bool bHasFloor = IsProbeHitWithin(FloorHitResult, GetWallSlideFloorDistance()) && FloorHitResult.IsValidBlockingHit();
+	if (!FAriaTraversalRules::CanKeepWallSliding(bHasWall, bHasFloor))
 	{
 		SetMovementMode(MOVE_Falling);
 	}
 }
 
-FVector UAriaCharacterMovement::EndDownVector(const FVector& Start) const
+float UAriaCharacterMovement::GetWallSlideFloorDistance() const
 {
-	return Start + FVector::DownVector * (GetCapsuleRadius() + MinHeightToSlide);
+	return FAriaTraversalRules::GetWallSlideFloorDistance(GetCapsuleRadius(), MinHeightToSlide);
 }
 
-FVector UAriaCharacterMovement::EndForwardVector(const FVector& Start) const
+float UAriaCharacterMovement::GetWallSlideWallDistance() const
 {
-	return Start + UpdatedComponent->GetForwardVector() * GetCapsuleRadius() * 2.2f;
+	return FAriaTraversalRules::GetWallSlideWallDistance(GetCapsuleRadius());
 }
 #pragma endregion
 
 #pragma region "Slide"
-bool UAriaCharacterMovement::CanSlide(FFindFloorResult& FloorHit) const
+void UAriaCharacterMovement::TryEnterSlide()
+{
+	ARIA_MOVEMENT_SCOPE(TryEnterSlide);
+
+	if (bWantsToSlide && CanSlide())
+	{
+		EnterSlide();
+	}
+}
+
+void UAriaCharacterMovement::TryExitSlide()
+{
+	ARIA_MOVEMENT_SCOPE(TryExitSlide);
+
+	if (!bWantsToSlide)
+	{
+		ExitSlide();
+	}
+}
+
+bool UAriaCharacterMovement::CanSlide() const
 {
 	if (Velocity.SizeSquared() <= pow(MinSpeedToEnterSlide, 2))
 	{
 		return false;
 	}
 
-	FindFloor(UpdatedComponent->GetComponentLocation(), FloorHit, false);
-	return FloorHit.bWalkableFloor;
+	return GetCachedFloor().bWalkableFloor;
 }
 
 void UAriaCharacterMovement::EnterSlide()
 {
 	SlidingTime = 0.f;
-	Velocity += Velocity.GetSafeNormal2D() * EnterSlideImpulse;
+	Velocity = FAriaTraversalRules::GetEnterSlideVelocity(Velocity, EnterSlideImpulse);
 
 	SetCollisionSizeToSlidingDimensions();
 	SetMovementMode(MOVE_Custom, CMOVE_Slide);
@@ -357,14 +1976,15 @@ void UAriaCharacterMovement::ExitSlide()
 
 void UAriaCharacterMovement::PhysSlide(float DeltaTime, int32 Iterations)
 {
+	ARIA_MOVEMENT_SCOPE(PhysSlide);
+
 	if (DeltaTime < MIN_TICK_TIME)
 	{
 		return;
 	}
 
 	RestorePreAdditiveRootMotionVelocity();
-	FFindFloorResult FloorHit;
-	if (!CanSlide(FloorHit))
+	if (!CanSlide())
 	{
 		ExitSlide();
 		StartNewPhysics(DeltaTime, Iterations);
@@ -389,12 +2009,14 @@ void UAriaCharacterMovement::PhysSlide(float DeltaTime, int32 Iterations)
 	ApplyRootMotionToVelocity(DeltaTime);
 
 	Iterations++;
+	ARIA_MOVEMENT_CSV_COUNT(CustomPhysIterations, 1);
 	bJustTeleported = false;
 	FVector OldLocation = UpdatedComponent->GetComponentLocation();
 	FHitResult HitResult(1.f);
 	FVector Adjusted = Velocity * DeltaTime;
-	FVector VelPlaneDir = FVector::VectorPlaneProject(Velocity, FloorHit.HitResult.Normal).GetSafeNormal();
-	FQuat NewRotation = FRotationMatrix::MakeFromXZ(VelPlaneDir, FloorHit.HitResult.Normal).ToQuat();
+	const FVector FloorNormal = GetCachedFloor().HitResult.Normal;
+	FVector VelPlaneDir = FVector::VectorPlaneProject(Velocity, FloorNormal).GetSafeNormal();
+	FQuat NewRotation = FRotationMatrix::MakeFromXZ(VelPlaneDir, FloorNormal).ToQuat();
 
 	// perform move
 	MoveUpdatedComponent(Adjusted, NewRotation, true, &HitResult);
@@ -405,19 +2027,16 @@ void UAriaCharacterMovement::PhysSlide(float DeltaTime, int32 Iterations)
 	}
 
 	// check if sliding conditions are met
-	if (FFindFloorResult NewFloorHit; !CanSlide(NewFloorHit))
+	if (!CanSlide())
 	{
 		ExitSlide();
 	}
 
 	// exit slide if maximum slide time is reached
-	if (MaxSlidingSeconds > 0.f)
+	SlidingTime += DeltaTime;
+	if (FAriaTraversalRules::HasSlideExpired(SlidingTime, MaxSlidingSeconds))
 	{
-		SlidingTime += DeltaTime;
-		if (SlidingTime >= MaxSlidingSeconds)
-		{
-			ExitSlide();
-		}
+		ExitSlide();
 	}
 
 	// update outgoing velocity && acceleration
@@ -429,31 +2048,28 @@ void UAriaCharacterMovement::PhysSlide(float DeltaTime, int32 Iterations)
 #pragma endregion 
 
 #pragma region "Rope Walking"
-bool UAriaCharacterMovement::CanRopeWalking(FHitResult& HitResult) const
+bool UAriaCharacterMovement::CanRopeWalking() const
 {
-	const FVector Start = UpdatedComponent->GetComponentLocation();
-	const FVector End = Start + FVector::DownVector * (CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + 5.f);
-	const FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
-
-	// check if the floor is the rope actor
-	GetWorld()->LineTraceSingleByProfile(HitResult, Start, End, "BlockAll", QueryParams);
-	if (!HitResult.IsValidBlockingHit())
+	if (!IsInsideTraversalVolume(EAriaSurfaceKind::Rope))
 	{
 		return false;
 	}
 
-	const TObjectPtr<AActor> Actor = HitResult.GetActor();
-	if (!Actor)
+	// check if the floor is the rope actor
+	const FHitResult& HitResult = ProbeDown();
+	if (!IsProbeHitWithin(HitResult, GetCapsuleHalfHeight() + 5.f) || !HitResult.IsValidBlockingHit())
 	{
 		return false;
 	}
 
-	return Actor->ActorHasTag(RopeTag);
+	return EnumHasAnyFlags(Probe.DownSurface, EAriaSurfaceKind::Rope);
 }
 
 void UAriaCharacterMovement::TryRopeWalking()
 {
-	if (FHitResult HitResult; !CanRopeWalking(HitResult))
+	ARIA_MOVEMENT_SCOPE(TryRopeWalking);
+
+	if (!CanRopeWalking())
 	{
 		return;
 	}
@@ -464,7 +2080,9 @@ void UAriaCharacterMovement::TryRopeWalking()
 
 void UAriaCharacterMovement::PhysRopeWalking(const float DeltaTime, const int32 Iterations)
 {
-	if (FHitResult HitResult; !CanRopeWalking(HitResult))
+	ARIA_MOVEMENT_SCOPE(PhysRopeWalking);
+
+	if (!CanRopeWalking())
 	{
 		SetMovementMode(DefaultLandMovementMode);
 		StartNewPhysics(DeltaTime, Iterations);
@@ -485,13 +2103,13 @@ void UAriaCharacterMovement::OnLanded(const FHitResult& HitResult)
 	if (GetLastInputVector().IsZero() || FMath::IsNearlyZero(GetSpeed()))
 	{
 		DisableMovement();
-		AriaCharacterOwner->PlayAnimMontage(HardLandingAnim);
+		PlayMovementMontage(HardLandingAnim);
 	}
 	else
 	{
 		bPrevCanJump = MovementState.bCanJump;
 		MovementState.bCanJump = false;
-		AriaCharacterOwner->PlayAnimMontage(FallingToRollAnim);
+		PlayMovementMontage(FallingToRollAnim);
 	}
 }
 
@@ -510,34 +2128,24 @@ void UAriaCharacterMovement::OnFallingToRollAnimFinished()
 bool UAriaCharacterMovement::CanPushing() const
 {
 	// check if the character is on walkable floor
-	FFindFloorResult FloorResult;
-	FindFloor(UpdatedComponent->GetComponentLocation(), FloorResult, false);
-	if (!FloorResult.bWalkableFloor)
+	if (!GetCachedFloor().bWalkableFloor)
 	{
 		return false;
 	}
 
 	// check if exist movable actor in front of the character
-	FHitResult HitResult;
-	FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
-	const FVector Start = UpdatedComponent->GetComponentLocation();
-	const FVector End = Start + UpdatedComponent->GetForwardVector() * ForwardSearchPushingLength;
-	if (!GetWorld()->LineTraceSingleByProfile(HitResult, Start, End, "BlockAll", QueryParams))
+	if (!IsProbeHitWithin(ProbeForward(), ForwardSearchPushingLength))
 	{
 		return false;
 	}
 
-	const TObjectPtr<AActor> Actor = HitResult.GetActor();
-	if (!Actor)
-	{
-		return false;
-	}
-	
-	return Actor->ActorHasTag(MovableTag);
+	return EnumHasAnyFlags(Probe.ForwardSurface, EAriaSurfaceKind::Movable);
 }
 
 void UAriaCharacterMovement::TryPushing()
 {
+	ARIA_MOVEMENT_SCOPE(TryPushing);
+
 	if (!CanPushing())
 	{
 		return;
@@ -546,11 +2154,14 @@ void UAriaCharacterMovement::TryPushing()
 	// change capsule size to pushing dimensions
 	const float OldUnscaleHalfHeight = CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
 	CharacterOwner->GetCapsuleComponent()->SetCapsuleSize(PushingCapsuleRadius, OldUnscaleHalfHeight);
+	InvalidateProbe();
 	SetMovementMode(MOVE_Custom, CMOVE_Pushing);
 }
 
 void UAriaCharacterMovement::PhysPushing(const float DeltaTime, const int32 Iterations)
 {
+	ARIA_MOVEMENT_SCOPE(PhysPushing);
+
 	if (!CanPushing())
 	{
 		// restore default capsule size
@@ -558,6 +2169,7 @@ void UAriaCharacterMovement::PhysPushing(const float DeltaTime, const int32 Iter
 		const float DefaultUnscaleRadius = DefaultCharacter->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
 		const float DefaultUnscaleHalfHeight = DefaultCharacter->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
 		CharacterOwner->GetCapsuleComponent()->SetCapsuleSize(DefaultUnscaleRadius, DefaultUnscaleHalfHeight);
+		InvalidateProbe();
 		SetMovementMode(DefaultLandMovementMode);
 	}
 
@@ -567,10 +2179,29 @@ void UAriaCharacterMovement::PhysPushing(const float DeltaTime, const int32 Iter
 #pragma endregion
 
 #pragma region "Crawling"
-bool UAriaCharacterMovement::CanCrawling(FFindFloorResult& FloorResult) const
+void UAriaCharacterMovement::TryEnterCrawling()
+{
+	ARIA_MOVEMENT_SCOPE(TryEnterCrawling);
+
+	if (bWantsToCrawling && CanCrawling())
+	{
+		EnterCrawling();
+	}
+}
+
+void UAriaCharacterMovement::TryExitCrawling()
+{
+	ARIA_MOVEMENT_SCOPE(TryExitCrawling);
+
+	if (!bWantsToCrawling)
+	{
+		ExitCrawling();
+	}
+}
+
+bool UAriaCharacterMovement::CanCrawling() const
 {
-	FindFloor(UpdatedComponent->GetComponentLocation(), FloorResult, false);
-	return FloorResult.bWalkableFloor;
+	return GetCachedFloor().bWalkableFloor;
 }
 
 void UAriaCharacterMovement::EnterCrawling()
@@ -602,8 +2233,10 @@ void UAriaCharacterMovement::ExitCrawling()
 
 void UAriaCharacterMovement::PhysCrawling(float DeltaTime, int32 Iterations)
 {
+	ARIA_MOVEMENT_SCOPE(PhysCrawling);
+
 	// check if crawling conditions are met
-	if (FFindFloorResult FloorResult; !CanCrawling(FloorResult))
+	if (!CanCrawling())
 	{
 		ExitCrawling();
 	}
@@ -612,7 +2245,7 @@ void UAriaCharacterMovement::PhysCrawling(float DeltaTime, int32 Iterations)
 	if (bWantsToMove && bIsCrawlingAnimFinished)
 	{
 		bIsCrawlingAnimFinished = false;
-		AriaCharacterOwner->PlayAnimMontage(CrawlingAnim);
+		PlayMovementMontage(CrawlingAnim);
 	}
 
 	// check if the player does not press Move and the animation is not finished
@@ -632,52 +2265,40 @@ void UAriaCharacterMovement::OnCrawlingAnimFinished()
 #pragma endregion 
 
 #pragma region "Mantle"
-void UAriaCharacterMovement::TryMantle()
+FAriaMantleQuery UAriaCharacterMovement::MakeMantleQuery() const
 {
-	if (!IsFalling() && !IsWallSliding() && !IsClimbLadder())
-	{
-		return;
-	}
-
-	// helper variables
-	float MinWallSteepnessAngleCos = FMath::Cos(FMath::DegreesToRadians(MantleMinWallSteepnessAngle));
-	float MaxSurfaceAngleCos = FMath::Cos(FMath::DegreesToRadians(MantleMaxSurfaceAngle));
-	float MaxAlignmentAngleCos = FMath::Cos(FMath::DegreesToRadians(MantleMaxAlignmentAngle));
-	FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
-
-	// check front face
-	FHitResult FrontResult;
-	FVector FrontStart = ComponentLocation + FVector::UpVector * MantleUpOffsetDistance;
-	FVector ForwardVector = UpdatedComponent->GetForwardVector().GetSafeNormal2D();
-	float CheckDistance = FMath::Clamp(Velocity | ForwardVector, GetCapsuleRadius() + 30.f, MaxFrontMantleCheckDistance);
-	FVector FrontEnd = FrontStart + ForwardVector * CheckDistance;
-	if (!GetWorld()->LineTraceSingleByProfile(FrontResult, FrontStart, FrontEnd, "BlockAll", QueryParams))
-	{
-		return;
-	}
+	FAriaMantleQuery Query;
+	Query.UpOffsetDistance = MantleUpOffsetDistance;
+	Query.ReachHeight = MantleReachHeight;
+	Query.MinWallSteepnessCos = FMath::Cos(FMath::DegreesToRadians(MantleMinWallSteepnessAngle));
+	Query.MaxSurfaceCos = FMath::Cos(FMath::DegreesToRadians(MantleMaxSurfaceAngle));
+	Query.MaxAlignmentCos = FMath::Cos(FMath::DegreesToRadians(MantleMaxAlignmentAngle));
+	return Query;
+}
 
+bool UAriaCharacterMovement::IsMantleWall(const FAriaMantleQuery& Query, const FHitResult& FrontResult, const FVector& ForwardVector)
+{
 	if (!FrontResult.IsValidBlockingHit())
 	{
-		return;
+		return false;
 	}
 
-	float CosWallSteepnessAngle = FrontResult.Normal | FVector::UpVector;
-	if (FMath::Abs(CosWallSteepnessAngle) > MinWallSteepnessAngleCos || (ForwardVector | -FrontResult.Normal) < MaxAlignmentAngleCos)
-	{
-		return;
-	}
-	
+	const float CosWallSteepnessAngle = FrontResult.Normal | FVector::UpVector;
+	return FMath::Abs(CosWallSteepnessAngle) <= Query.MinWallSteepnessCos && (ForwardVector | -FrontResult.Normal) >= Query.MaxAlignmentCos;
+}
+
+bool UAriaCharacterMovement::FindMantleLedge(const UWorld* World, const FCollisionQueryParams& QueryParams, const FAriaMantleQuery& Query, const FHitResult& FrontResult, const FVector& FrontStart, const FVector& ForwardVector, const float CapsuleRadius, const float CapsuleHalfHeight, FAriaMantleLedge& OutLedge)
+{
 	// check heights
 	TArray<FHitResult> HeightHits;
 	FHitResult SurfaceHit;
-	FVector WallUp = FVector::VectorPlaneProject(FVector::UpVector, FrontResult.Normal).GetSafeNormal();
-	float WallCos = FVector::UpVector | FrontResult.Normal;
-	float WallSin = FMath::Sqrt(1 - WallCos * WallCos);
-	FVector TraceStart = FrontResult.Location + ForwardVector + WallUp * MantleReachHeight / WallSin;
-	if (!GetWorld()->LineTraceMultiByProfile(HeightHits, TraceStart, FrontResult.Location + ForwardVector, "BlockAll", QueryParams))
+	const FVector WallUp = FVector::VectorPlaneProject(FVector::UpVector, FrontResult.Normal).GetSafeNormal();
+	const float WallCos = FVector::UpVector | FrontResult.Normal;
+	const float WallSin = FMath::Sqrt(1 - WallCos * WallCos);
+	const FVector TraceStart = FrontResult.Location + ForwardVector + WallUp * Query.ReachHeight / WallSin;
+	if (!World->LineTraceMultiByProfile(HeightHits, TraceStart, FrontResult.Location + ForwardVector, "BlockAll", QueryParams))
 	{
-		return;
+		return false;
 	}
 
 	for (const FHitResult& Hit : HeightHits)
@@ -689,23 +2310,79 @@ void UAriaCharacterMovement::TryMantle()
 		}
 	}
 
-	if (!SurfaceHit.IsValidBlockingHit() || (SurfaceHit.Normal | FVector::UpVector) < MaxSurfaceAngleCos)
+	if (!SurfaceHit.IsValidBlockingHit() || (SurfaceHit.Normal | FVector::UpVector) < Query.MaxSurfaceCos)
 	{
-		return;
+		return false;
 	}
 
-	float Height = SurfaceHit.Location - FrontStart | FVector::UpVector;
-	if (Height > MantleReachHeight)
+	const float Height = SurfaceHit.Location - FrontStart | FVector::UpVector;
+	if (Height > Query.ReachHeight)
 	{
-		return;
+		return false;
+	}
+
+	// capsule location on top of the ledge
+	const float SurfaceCos = FVector::UpVector | SurfaceHit.Normal;
+	const float SurfaceSin = FMath::Sqrt(1 - SurfaceCos * SurfaceCos);
+	OutLedge.Surface = SurfaceHit.Location;
+	OutLedge.SurfaceNormal = SurfaceHit.Normal;
+	OutLedge.WallNormal = FrontResult.Normal;
+	OutLedge.Target = SurfaceHit.Location + ForwardVector * CapsuleRadius + FVector::UpVector * (CapsuleHalfHeight + CapsuleRadius * 2 * SurfaceSin);
+	return true;
+}
+
+void UAriaCharacterMovement::TryMantle()
+{
+	ARIA_MOVEMENT_SCOPE(TryMantle);
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector FrontStart = ComponentLocation + FVector::UpVector * MantleUpOffsetDistance;
+	const FVector ForwardVector = UpdatedComponent->GetForwardVector().GetSafeNormal2D();
+	const float CheckDistance = FMath::Clamp(Velocity | ForwardVector, GetCapsuleRadius() + 30.f, MaxFrontMantleCheckDistance);
+
+	// look the ledge up in the baked database when the level has one, otherwise probe the geometry
+	FAriaMantleLedge Ledge;
+	bool bHasLedge = false;
+	const UMantleLedgeSubsystem* LedgeSubsystem = GetWorld()->GetSubsystem<UMantleLedgeSubsystem>();
+	const bool bHasLedgeDatabase = LedgeSubsystem && LedgeSubsystem->HasLedges();
+	if (bHasLedgeDatabase && LedgeSubsystem->FindLedge(FrontStart, ForwardVector, CheckDistance, GetCapsuleRadius(), MantleQuery, Ledge))
+	{
+		// the database only holds static geometry, confirm the surface is still there and free before committing to the mantle
+		FHitResult SurfaceHit;
+		if (!TraceLine(SurfaceHit, Ledge.Surface + FVector::UpVector * 10.f, Ledge.Surface - FVector::UpVector * 10.f, SCENE_QUERY_STAT(AriaMantleLedgeConfirm)) || SurfaceHit.bStartPenetrating)
+		{
+			return;
+		}
+
+		bHasLedge = true;
+	}
+
+	if (!bHasLedge)
+	{
+		const FHitResult& FrontResult = ProbeLedge(CheckDistance);
+		if (!IsProbeHitWithin(FrontResult, CheckDistance) || !IsMantleWall(MantleQuery, FrontResult, ForwardVector))
+		{
+			return;
+		}
+
+		// the bake covers every static wall, only movables and moving platforms are left to probe
+		const UPrimitiveComponent* WallComponent = FrontResult.GetComponent();
+		if (bHasLedgeDatabase && WallComponent && WallComponent->Mobility == EComponentMobility::Static)
+		{
+			return;
+		}
+
+		CountSceneQuery();
+		if (!FindMantleLedge(GetWorld(), AriaCharacterOwner->GetQueryParams(SCENE_QUERY_STAT(AriaMantleLedge)), MantleQuery, FrontResult, FrontStart, ForwardVector, GetCapsuleRadius(), GetCapsuleHalfHeight(), Ledge))
+		{
+			return;
+		}
 	}
 
-	// check clearance
-	float SurfaceCos = FVector::UpVector | SurfaceHit.Normal;
-	float SurfaceSin = FMath::Sqrt(1 - SurfaceCos * SurfaceCos);
-	FVector TransitionTarget = SurfaceHit.Location + ForwardVector * GetCapsuleRadius() + FVector::UpVector * (GetCapsuleHalfHeight() + GetCapsuleRadius() * 2 * SurfaceSin);
-	FCollisionShape CapShape = FCollisionShape::MakeCapsule(GetCapsuleRadius(), GetCapsuleHalfHeight());
-	if (GetWorld()->OverlapAnyTestByProfile(TransitionTarget, FQuat::Identity, "BlockAll", CapShape, QueryParams))
+	// check clearance, dynamic actors may block a baked ledge
+	const FVector TransitionTarget = Ledge.Target;
+	const FCollisionShape CapShape = FCollisionShape::MakeCapsule(GetCapsuleRadius(), GetCapsuleHalfHeight());
+	if (OverlapCapsule(TransitionTarget, CapShape, SCENE_QUERY_STAT(AriaMantleClearance)))
 	{
 		return;
 	}
@@ -726,7 +2403,7 @@ void UAriaCharacterMovement::TryMantle()
 	RootMotionSourceID = ApplyRootMotionSource(RootMotionSource);
 
 	// animation
-	AriaCharacterOwner->PlayAnimMontage(MantleAnim);
+	PlayMovementMontage(MantleAnim);
 }
 
 void UAriaCharacterMovement::OnMantleAnimFinished()
@@ -737,70 +2414,46 @@ void UAriaCharacterMovement::OnMantleAnimFinished()
 #pragma endregion
 
 #pragma region "Climb Ladder"
-float UAriaCharacterMovement::GetClimbLadderDirection()
-{
-	// remember last climb direction to play Idle Up or Down animation
-	const FVector Forward = UpdatedComponent->GetForwardVector();
-	const float LastInputVector = GetLastInputVector().X * Forward.X;
-	if (FMath::IsNearlyZero(LastClimbDirection) || (!FMath::IsNearlyZero(LastInputVector) && LastInputVector != LastClimbDirection))
-	{
-		LastClimbDirection = LastInputVector;
-	}
-
-	return LastClimbDirection;
-}
-
-bool UAriaCharacterMovement::CanClimbLadder(FHitResult& LadderHit) const
+bool UAriaCharacterMovement::CanClimbLadder() const
 {
-	if (MovementMode == MOVE_Flying)
+	if (MovementMode == MOVE_Flying || !IsInsideTraversalVolume(EAriaSurfaceKind::Ladder))
 	{
 		return false;
 	}
-	
-	const FVector Start = UpdatedComponent->GetComponentLocation();
-	const FVector ForwardVector = UpdatedComponent->GetForwardVector();
-	const FCollisionQueryParams QueryParams = AriaCharacterOwner->GetQueryParams();
 
-	// exit climb ladder if the player pressed back button and the height to floor is smaller than MinHeightToClimbLadder
-	const FVector InputVector = GetLastInputVector();
-	if (!InputVector.IsNearlyZero() && !InputVector.Equals(ForwardVector))
+	// exit climb ladder if the player pressed back button and the height to floor is smaller than MinHeightToClimbLadder.
+	// read from the acceleration like the climb input, the server never sees the last input vector
+	if (!Acceleration.IsNearlyZero() && (Acceleration | UpdatedComponent->GetForwardVector()) <= 0.f)
 	{
-		const FVector DownVector = Start + FVector::DownVector * (GetCapsuleRadius() + MinHeightToClimbLadder);
-		if (FHitResult FloorHit; GetWorld()->LineTraceSingleByProfile(FloorHit, Start, DownVector, "BlockAll", QueryParams))
+		if (IsProbeHitWithin(ProbeDown(), GetCapsuleRadius() + MinHeightToClimbLadder))
 		{
 			return false;
 		}
 	}
 
 	// check if the hit actor is ladder
-	const FVector End = Start + ForwardVector * ForwardDistanceToCheckLadder;
-	GetWorld()->LineTraceSingleByProfile(LadderHit, Start, End, "BlockAll", QueryParams);
-	if (!LadderHit.IsValidBlockingHit())
-	{
-		return false;
-	}
-
-	TObjectPtr<AActor> LadderActor = LadderHit.GetActor();
-	if (!LadderActor || !LadderActor->ActorHasTag(ClimbLadderTag))
+	const FHitResult& LadderHit = ProbeForward();
+	if (!IsProbeHitWithin(LadderHit, ForwardDistanceToCheckLadder) || !LadderHit.IsValidBlockingHit())
 	{
 		return false;
 	}
 
-	return true;
+	return EnumHasAnyFlags(Probe.ForwardSurface, EAriaSurfaceKind::Ladder);
 }
 
 void UAriaCharacterMovement::TryClimbLadder()
 {
-	FHitResult LadderHit;
-	if (!CanClimbLadder(LadderHit))
+	ARIA_MOVEMENT_SCOPE(TryClimbLadder);
+
+	if (!CanClimbLadder())
 	{
-		return;;
+		return;
 	}
 
 	// reset velocity if the character falls down to the ladder
 	if (IsFalling())
 	{
-		Velocity = FVector::VectorPlaneProject(Velocity, LadderHit.Normal).GetSafeNormal2D();
+		Velocity = FVector::VectorPlaneProject(Velocity, ProbeForward().Normal).GetSafeNormal2D();
 	}
 
 	SetMovementMode(MOVE_Custom, CMOVE_ClimbLadder);
@@ -808,6 +2461,8 @@ void UAriaCharacterMovement::TryClimbLadder()
 
 void UAriaCharacterMovement::PhysClimbLadder(float DeltaTime, int32 Iterations)
 {
+	ARIA_MOVEMENT_SCOPE(PhysClimbLadder);
+
 	if (DeltaTime < MIN_TICK_TIME)
 	{
 		return;
@@ -826,25 +2481,28 @@ void UAriaCharacterMovement::PhysClimbLadder(float DeltaTime, int32 Iterations)
 	while (CanPerformFrameTickMovement(RemainingTime, Iterations))
 	{
 		Iterations++;
+		ARIA_MOVEMENT_CSV_COUNT(CustomPhysIterations, 1);
 		bJustTeleported = false;
 		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
 		RemainingTime -= TimeTick;
 
-		FHitResult LadderHit;
-		if (!CanClimbLadder(LadderHit))
+		if (!CanClimbLadder())
 		{
 			SetMovementMode(MOVE_Falling);
 			StartNewPhysics(RemainingTime, Iterations);
 			return;
 		}
 
+		// the input toward the ladder climbs, a server only gets it through the acceleration of the client move
+		const float ClimbInput = FMath::Clamp(Acceleration.X * Forward.X / FMath::Max(GetMaxAcceleration(), UE_SMALL_NUMBER), -1.f, 1.f);
+
 		// clamp acceleration
-		Acceleration = FVector::VectorPlaneProject(Acceleration, LadderHit.Normal);
+		const FVector LadderNormal = ProbeForward().Normal;
+		Acceleration = FVector::VectorPlaneProject(Acceleration, LadderNormal);
 
 		// apply acceleration
 		CalcVelocity(TimeTick, 0.f, false, GetMaxBrakingDeceleration());
-		Velocity = FVector::VectorPlaneProject(Velocity, LadderHit.Normal);
-		Velocity.Z = MaxClimbLadderSpeed * GetLastInputVector().X * Forward.X;
+		Velocity = FAriaTraversalRules::GetClimbLadderVelocity(Velocity, LadderNormal, MaxClimbLadderSpeed, ClimbInput);
 
 		// compute move parameters
 		FHitResult HitResult;
@@ -852,7 +2510,7 @@ void UAriaCharacterMovement::PhysClimbLadder(float DeltaTime, int32 Iterations)
 	}
 
 	// check again if the climb conditions are met
-	if (FHitResult HitResult; !CanClimbLadder(HitResult))
+	if (!CanClimbLadder())
 	{
 		SetMovementMode(MOVE_Falling);
 	}
@@ -863,6 +2521,8 @@ void UAriaCharacterMovement::PhysClimbLadder(float DeltaTime, int32 Iterations)
 #pragma region "Dash"
 void UAriaCharacterMovement::TryDash()
 {
+	ARIA_MOVEMENT_SCOPE(TryDash);
+
 	if (!CanDash())
 	{
 		return;
@@ -884,7 +2544,7 @@ bool UAriaCharacterMovement::CanDash()
 		return false;
 	}
 
-	if (GetWorld()->GetTimeSeconds() - DashStartTime < DashCooldown)
+	if (DashCooldownRemaining > 0.f)
 	{
 		return false;
 	}
@@ -898,11 +2558,11 @@ void UAriaCharacterMovement::PerformDash()
 	{
 		bIsDashInProgress = true;
 		SetMovementMode(MOVE_Flying);
-		AriaCharacterOwner->PlayAnimMontage(GroundedDashAnim);
+		PlayMovementMontage(GroundedDashAnim);
 	}
 	else
 	{
-		DashStartTime = GetWorld()->GetTimeSeconds();
+		DashCooldownRemaining = DashCooldown;
 		if (Velocity.Z < 0 || GetLastInputVector().IsNearlyZero())
 		{
 			Velocity.Z -= FallingDashImpulse;
@@ -925,12 +2585,9 @@ void UAriaCharacterMovement::OnDashAnimFinished()
 #pragma region "Ice Sliding"
 void UAriaCharacterMovement::TryIceSliding()
 {
-	if (!CanIceSliding())
-	{
-		return;
-	}
+	ARIA_MOVEMENT_SCOPE(TryIceSliding);
 
-	if (IsIceSliding())
+	if (!CanIceSliding())
 	{
 		return;
 	}
@@ -947,24 +2604,18 @@ void UAriaCharacterMovement::TryIceSliding()
 
 bool UAriaCharacterMovement::CanIceSliding() const
 {
-	FFindFloorResult FloorResult;
-	FindFloor(UpdatedComponent->GetComponentLocation(), FloorResult, false);
-	if (!FloorResult.bWalkableFloor)
-	{
-		return false;
-	}
-
-	const TObjectPtr<AActor> FloorActor = FloorResult.HitResult.GetActor();
-	if (!FloorActor)
+	if (!IsInsideTraversalVolume(EAriaSurfaceKind::Ice) || !GetCachedFloor().bWalkableFloor)
 	{
 		return false;
 	}
 
-	return FloorActor->ActorHasTag(IceTag);
+	return EnumHasAnyFlags(FloorCache.Surface, EAriaSurfaceKind::Ice);
 }
 
 void UAriaCharacterMovement::PhysIceSliding(float DeltaTime, int32 Iterations)
 {
+	ARIA_MOVEMENT_SCOPE(PhysIceSliding);
+
 	if (!CanIceSliding())
 	{
 		// restore walking params
@@ -979,6 +2630,29 @@ void UAriaCharacterMovement::PhysIceSliding(float DeltaTime, int32 Iterations)
 #pragma endregion
 
 #pragma region "Helpers"
+bool UAriaCharacterMovement::IsSimulatedProxy() const
+{
+	return CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy;
+}
+
+void UAriaCharacterMovement::PlayMovementMontage(UAnimMontage* Montage)
+{
+	// the montage already started when the move was first simulated
+	if (CharacterOwner->bClientUpdating)
+	{
+		return;
+	}
+
+	// the new montage takes over the slot, the ones it interrupts don't finish their modes anymore
+	PendingAnimEvents = 0;
+	if (EAriaAnimEvent Event; GetMontageEvent(Montage, Event))
+	{
+		PendingAnimEvents |= 1 << static_cast<uint8>(Event);
+	}
+
+	AriaCharacterOwner->PlayAnimMontage(Montage);
+}
+
 float UAriaCharacterMovement::GetCapsuleRadius() const
 {
 	return CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius();
@@ -1024,6 +2698,7 @@ void UAriaCharacterMovement::SetCollisionSizeToSlidingDimensions()
 	}
 
 	bForceNextFloorCheck = true;
+	InvalidateProbe();
 
 	// OnStartCrouch takes the change from the Default size, not the current one (though they are usually the same)
 	const ACharacter* DefaultCharacter = CharacterOwner->GetClass()->GetDefaultObject<ACharacter>();
@@ -1058,6 +2733,7 @@ bool UAriaCharacterMovement::RestoreDefaultCollisionDimensions()
 	if (!bCrouchMaintainsBaseLocation)
 	{
 		// expand in place
+		CountSceneQuery();
 		bEncroached = MyWorld->OverlapBlockingTestByChannel(PawnLocation, FQuat::Identity, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 		if (bEncroached)
 		{
@@ -1073,6 +2749,7 @@ bool UAriaCharacterMovement::RestoreDefaultCollisionDimensions()
 
 				FHitResult Hit(1.f);
 				const FCollisionShape ShortCapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_HeightCustom, ShrinkHalfHeight);
+				CountSceneQuery();
 				MyWorld->SweepSingleByChannel(Hit, PawnLocation, PawnLocation + Down, FQuat::Identity, CollisionChannel, ShortCapsuleShape, CapsuleParams);
 				if (Hit.bStartPenetrating)
 				{
@@ -1083,6 +2760,7 @@ bool UAriaCharacterMovement::RestoreDefaultCollisionDimensions()
 					// compute where the base of the sweep ended up, and see if we can stand there
 					const float DistanceToBase = (Hit.Time * TraceDist) + ShortCapsuleShape.Capsule.HalfHeight;
 					const FVector NewLoc = FVector(PawnLocation.X, PawnLocation.Y, PawnLocation.Z - DistanceToBase + StandingCapsuleShape.Capsule.HalfHeight + SweepInflation + MIN_FLOOR_DIST / 2.f);
+					CountSceneQuery();
 					bEncroached = MyWorld->OverlapBlockingTestByChannel(NewLoc, FQuat::Identity, CollisionChannel, StandingCapsuleShape, CapsuleParams, ResponseParam);
 					if (!bEncroached)
 					{
@@ -1102,37 +2780,10 @@ bool UAriaCharacterMovement::RestoreDefaultCollisionDimensions()
 
 	// now call SetCapsuleSize() to cause touch/untouch events and actually grow the capsule
 	CharacterOwner->GetCapsuleComponent()->SetCapsuleSize(DefaultCharacter->GetCapsuleComponent()->GetUnscaledCapsuleRadius(), DefaultCharacter->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight(), true);
+	InvalidateProbe();
 	AdjustProxyCapsuleSize();
 	CharacterOwner->OnEndCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
 
 	return true;
 }
-
-void UAriaCharacterMovement::InitAnimations()
-{
-	if (const auto HardLandingNotify = FindNotifyByClass<UHardLandingAnimNotify>(HardLandingAnim))
-	{
-		HardLandingNotify->OnNotified.AddUObject(this, &UAriaCharacterMovement::OnHardLandingAnimFinished);
-	}
-
-	if (const auto FallingToRollNotify = FindNotifyByClass<UFallingToRollAnimNotify>(FallingToRollAnim))
-	{
-		FallingToRollNotify->OnNotified.AddUObject(this, &UAriaCharacterMovement::OnFallingToRollAnimFinished);
-	}
-
-	if (const auto CrawlingNotify = FindNotifyByClass<UCrawlingAnimNotify>(CrawlingAnim))
-	{
-		CrawlingNotify->OnNotified.AddUObject(this, &UAriaCharacterMovement::OnCrawlingAnimFinished);
-	}
-
-	if (const auto MantleNotify = FindNotifyByClass<UMantleAnimNotify>(MantleAnim))
-	{
-		MantleNotify->OnNotified.AddUObject(this, &UAriaCharacterMovement::OnMantleAnimFinished);
-	}
-
-	if (const auto DashNotify = FindNotifyByClass<UDashAnimNotify>(GroundedDashAnim))
-	{
-		DashNotify->OnNotified.AddUObject(this, &UAriaCharacterMovement::OnDashAnimFinished);
-	}
-}
 #pragma endregion
\ No newline at end of file
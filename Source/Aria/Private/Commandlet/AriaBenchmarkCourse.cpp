@@ -0,0 +1,241 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Commandlet/AriaBenchmarkCourse.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Interactable/MovableActor.h"
+#include "Manager/AriaMovementSubsystem.h"
+
+namespace AriaBenchmarkCourse
+{
+	enum class ESegment : uint8
+	{
+		Flat,
+		Ice,
+		Ledge,
+		Wall,
+		Ladder,
+		Rope,
+		Movable,
+		Drop,
+		Count,
+	};
+}
+
+#pragma region "Course"
+
+UWorld* FAriaBenchmarkCourse::CreateWorld(const TCHAR* Name)
+{
+	UWorld* NewWorld = UWorld::CreateWorld(EWorldType::Game, false, Name);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(NewWorld);
+	const FURL URL;
+	NewWorld->SetGameMode(URL);
+	NewWorld->InitializeActorsForPlay(URL);
+	NewWorld->BeginPlay();
+	return NewWorld;
+}
+
+void FAriaBenchmarkCourse::DestroyWorld(UWorld* InWorld)
+{
+	GEngine->DestroyWorldContext(InWorld);
+	InWorld->DestroyWorld(false);
+}
+
+FString FAriaBenchmarkCourse::GetModeName(const UAriaCharacterMovement* InMovement)
+{
+	if (InMovement->MovementMode == MOVE_Custom)
+	{
+		return StaticEnum<ECustomMovementMode>()->GetNameStringByValue(InMovement->CustomMovementMode);
+	}
+
+	return StaticEnum<EMovementMode>()->GetNameStringByValue(InMovement->MovementMode);
+}
+
+void FAriaBenchmarkCourse::Build(const int32 Seed)
+{
+	using namespace AriaBenchmarkCourse;
+
+	FRandomStream Stream(Seed);
+	float FloorZ = 0.f;
+	for (int32 Index = 0; Index < SegmentCount; Index++)
+	{
+		const float StartX = Index * SegmentLength - SegmentLength;
+		const float MidX = StartX + SegmentLength * .5f;
+		const float SegmentEndX = StartX + SegmentLength;
+
+		// the first segment is where the characters land
+		const ESegment Segment = Index == 0 ? ESegment::Flat : static_cast<ESegment>(Stream.RandRange(0, static_cast<int32>(ESegment::Count) - 1));
+		switch (Segment)
+		{
+			case ESegment::Flat:
+				AddFloor(StartX, SegmentEndX, FloorZ);
+				break;
+			case ESegment::Ice:
+				AddFloor(StartX, SegmentEndX, FloorZ, EAriaSurfaceKind::Ice, Movement->IceTag);
+				break;
+			case ESegment::Ledge:
+			{
+				// low enough to mantle from a jump
+				const float LedgeHeight = Stream.FRandRange(100.f, 180.f);
+				AddFloor(StartX, SegmentEndX, FloorZ);
+				AddBlock(FVector(MidX - 100.f, -LaneSpacing, FloorZ), FVector(MidX + 100.f, LaneCount * LaneSpacing, FloorZ + LedgeHeight));
+				break;
+			}
+			case ESegment::Wall:
+				// running off the edge slides down the far wall of the pit
+				AddFloor(StartX, MidX, FloorZ);
+				AddFloor(MidX, SegmentEndX, FloorZ - PitDepth);
+				AddBlock(FVector(SegmentEndX - 100.f, -LaneSpacing, FloorZ - PitDepth), FVector(SegmentEndX, LaneCount * LaneSpacing, FloorZ + Stream.FRandRange(200.f, 400.f)));
+				break;
+			case ESegment::Ladder:
+				AddFloor(StartX, SegmentEndX, FloorZ);
+				AddBlock(FVector(SegmentEndX - 100.f, -LaneSpacing, FloorZ), FVector(SegmentEndX, LaneCount * LaneSpacing, FloorZ + 600.f), EAriaSurfaceKind::Ladder, Movement->ClimbLadderTag);
+				break;
+			case ESegment::Rope:
+				// one rope per lane across a pit
+				AddFloor(StartX, StartX + 100.f, FloorZ);
+				AddFloor(SegmentEndX - 100.f, SegmentEndX, FloorZ);
+				AddFloor(StartX + 100.f, SegmentEndX - 100.f, FloorZ - PitDepth);
+				for (int32 Lane = 0; Lane < LaneCount; Lane++)
+				{
+					AddBlock(FVector(StartX + 100.f, Lane * LaneSpacing - 5.f, FloorZ - 10.f), FVector(SegmentEndX - 100.f, Lane * LaneSpacing + 5.f, FloorZ), EAriaSurfaceKind::Rope, Movement->RopeTag);
+				}
+				break;
+			case ESegment::Movable:
+				AddFloor(StartX, SegmentEndX, FloorZ);
+				for (int32 Lane = 0; Lane < LaneCount; Lane++)
+				{
+					const FTransform Transform(FVector(MidX, Lane * LaneSpacing, FloorZ + 50.f));
+					AMovableActor* MovableActor = World->SpawnActorDeferred<AMovableActor>(AMovableActor::StaticClass(), Transform);
+					MovableActor->MeshComponent->SetStaticMesh(Cube);
+					MovableActor->MeshComponent->SetPhysMaterialOverride(GetMaterial(EAriaSurfaceKind::Movable));
+					MovableActor->FinishSpawning(Transform);
+				}
+				break;
+			case ESegment::Drop:
+				// high enough for a hard landing
+				AddFloor(StartX, MidX, FloorZ);
+				FloorZ -= Stream.FRandRange(300.f, 1800.f);
+				AddFloor(MidX, SegmentEndX, FloorZ);
+				break;
+			default:
+				break;
+		}
+	}
+
+	EndX = (SegmentCount - 1) * SegmentLength;
+}
+
+FVector FAriaBenchmarkCourse::GetStartLocation(const int32 Lane) const
+{
+	return FVector(-SegmentLength * .5f, Lane * LaneSpacing, 200.f);
+}
+
+AAriaCharacter* FAriaBenchmarkCourse::SpawnCharacter(UClass* CharacterClass, const int32 Lane) const
+{
+	const FTransform Transform(GetStartLocation(Lane));
+	AAriaCharacter* Character = World->SpawnActorDeferred<AAriaCharacter>(CharacterClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	UAriaCharacterMovement* CharacterMovement = Cast<UAriaCharacterMovement>(Character->GetCharacterMovement());
+	CharacterMovement->bRunPhysicsWithNoController = true;
+	CharacterMovement->bEnableMovementLod = false;
+	Character->FinishSpawning(Transform);
+
+	if (UAriaMovementSubsystem* MovementSubsystem = World->GetSubsystem<UAriaMovementSubsystem>())
+	{
+		MovementSubsystem->UnregisterMovement(CharacterMovement);
+	}
+
+	CharacterMovement->SetComponentTickEnabled(false);
+	return Character;
+}
+
+void FAriaBenchmarkCourse::AddBlock(const FVector& Min, const FVector& Max, const EAriaSurfaceKind SurfaceKind, const FName Tag)
+{
+	// the engine cube is 100 units wide
+	const FTransform Transform(FRotator::ZeroRotator, (Min + Max) * .5f, (Max - Min) / 100.f);
+	AStaticMeshActor* Block = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+	Block->GetStaticMeshComponent()->SetStaticMesh(Cube);
+	if (SurfaceKind != EAriaSurfaceKind::None)
+	{
+		Block->GetStaticMeshComponent()->SetPhysMaterialOverride(GetMaterial(SurfaceKind));
+		if (!Tag.IsNone())
+		{
+			Block->Tags.Add(Tag);
+		}
+	}
+
+	Block->FinishSpawning(Transform);
+}
+
+void FAriaBenchmarkCourse::AddFloor(const float StartX, const float FloorEndX, const float TopZ, const EAriaSurfaceKind SurfaceKind, const FName Tag)
+{
+	AddBlock(FVector(StartX, -LaneSpacing, TopZ - 100.f), FVector(FloorEndX, LaneCount * LaneSpacing, TopZ), SurfaceKind, Tag);
+}
+
+UAriaPhysicalMaterial* FAriaBenchmarkCourse::GetMaterial(const EAriaSurfaceKind SurfaceKind)
+{
+	UAriaPhysicalMaterial*& Material = Materials.FindOrAdd(SurfaceKind);
+	if (!Material)
+	{
+		Material = NewObject<UAriaPhysicalMaterial>(World);
+		Material->SurfaceKinds = static_cast<int32>(SurfaceKind);
+	}
+
+	return Material;
+}
+
+#pragma endregion
+
+#pragma region "Script"
+
+FAriaBenchmarkScript::FAriaBenchmarkScript(const int32 Seed, const FVector& InStartLocation)
+	: Stream(Seed), StartLocation(InStartLocation), CheckpointX(InStartLocation.X)
+{
+}
+
+void FAriaBenchmarkScript::Step(AAriaCharacter* Character, UAriaCharacterMovement* Movement, const int32 Frame, const float CourseEndX)
+{
+	const float X = Character->GetActorLocation().X;
+	const bool bCheckStuck = Frame % StuckCheckFrames == StuckCheckFrames - 1;
+	if (X > CourseEndX || (bCheckStuck && X - CheckpointX < 100.f))
+	{
+		Movement->StopMovementImmediately();
+		Movement->SetMovementMode(MOVE_Falling);
+		Character->SetActorLocation(StartLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	if (bCheckStuck)
+	{
+		CheckpointX = Character->GetActorLocation().X;
+	}
+
+	Character->StopJumping();
+	Character->AddMovementInput(FVector::ForwardVector);
+	Movement->bWantsToMove = true;
+	Movement->bWantsToSlide = SlideFrames-- > 0;
+	Movement->bWantsToDash = false;
+	const float Action = Stream.FRand();
+	if (Action < .02f)
+	{
+		Character->Jump();
+	}
+	else if (Action < .03f)
+	{
+		SlideFrames = Stream.RandRange(10, 40);
+	}
+	else if (Action < .035f)
+	{
+		Movement->bWantsToCrawling = !Movement->bWantsToCrawling;
+	}
+	else if (Action < .04f)
+	{
+		Movement->bWantsToDash = true;
+	}
+}
+
+#pragma endregion
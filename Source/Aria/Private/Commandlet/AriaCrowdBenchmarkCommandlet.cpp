@@ -0,0 +1,154 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Commandlet/AriaCrowdBenchmarkCommandlet.h"
+#include "EngineUtils.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "GameFramework/PlayerStart.h"
+#include "Manager/AriaCrowdSubsystem.h"
+
+DEFINE_LOG_CATEGORY(LogAriaCrowdBenchmark);
+
+namespace AriaCrowdBenchmark
+{
+	constexpr float FrameTime = 1.f / 60.f;
+
+	/**
+	 *	Ticks the world a fixed number of frames and returns the average milliseconds per frame
+	 */
+	double TickFrames(UWorld* World, const int32 Frames, const TFunctionRef<void()> BeforeTick)
+	{
+		double TotalSeconds = 0.0;
+		for (int32 Frame = 0; Frame < Frames; Frame++)
+		{
+			BeforeTick();
+			const double StartTime = FPlatformTime::Seconds();
+			World->Tick(LEVELTICK_All, FrameTime);
+			TotalSeconds += FPlatformTime::Seconds() - StartTime;
+			GFrameCounter++;
+		}
+
+		return Frames > 0 ? TotalSeconds * 1000.0 / Frames : 0.0;
+	}
+}
+
+UAriaCrowdBenchmarkCommandlet::UAriaCrowdBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAriaCrowdBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace AriaCrowdBenchmark;
+
+	FString MapName;
+	FString CharacterClassName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName) || !FParse::Value(*Params, TEXT("Character="), CharacterClassName))
+	{
+		UE_LOG(LogAriaCrowdBenchmark, Error, TEXT("Usage: -run=AriaCrowdBenchmark -Map=<package> -Character=<class path> [-Count=] [-Frames=]"));
+		return 1;
+	}
+
+	int32 Count = 200;
+	int32 Frames = 600;
+	FParse::Value(*Params, TEXT("Count="), Count);
+	FParse::Value(*Params, TEXT("Frames="), Frames);
+
+	UClass* CharacterClass = LoadClass<AAriaCharacter>(nullptr, *CharacterClassName);
+	if (!CharacterClass)
+	{
+		UE_LOG(LogAriaCrowdBenchmark, Error, TEXT("Failed to load character class %s"), *CharacterClassName);
+		return 1;
+	}
+
+	// the level has to play so the movement components and the subsystems tick
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogAriaCrowdBenchmark, Error, TEXT("Failed to load map %s"), *MapName);
+		return 1;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+	World->InitWorld(UWorld::InitializationValues().AllowAudioPlayback(false).CreatePhysicsScene(true).CreateNavigation(false).CreateAISystem(false));
+	World->UpdateWorldComponents(true, false);
+
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	// both crowds start in the same row behind the player start
+	FVector Origin = FVector::ZeroVector;
+	if (TActorIterator<APlayerStart> PlayerStart(World); PlayerStart)
+	{
+		Origin = PlayerStart->GetActorLocation();
+	}
+
+	TArray<FVector> Locations;
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		Locations.Add(Origin - FVector(150.f * Index, 0.f, 0.f));
+	}
+
+	// full simulation for every character, the runners have no LOD either
+	TArray<AAriaCharacter*> Characters;
+	for (const FVector& Location : Locations)
+	{
+		const FTransform Transform(Location);
+		if (AAriaCharacter* Character = World->SpawnActorDeferred<AAriaCharacter>(CharacterClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn))
+		{
+			UAriaCharacterMovement* Movement = Cast<UAriaCharacterMovement>(Character->GetCharacterMovement());
+			Movement->bRunPhysicsWithNoController = true;
+			Movement->bEnableMovementLod = false;
+			Character->FinishSpawning(Transform);
+			Characters.Add(Character);
+		}
+	}
+
+	const double CharacterMs = TickFrames(World, Frames, [&Characters]
+	{
+		for (AAriaCharacter* Character : Characters)
+		{
+			Character->AddMovementInput(FVector::ForwardVector);
+		}
+	});
+
+	for (AAriaCharacter* Character : Characters)
+	{
+		Character->Destroy();
+	}
+
+	const double EmptyMs = TickFrames(World, Frames, [] {});
+
+	UAriaCrowdSubsystem* CrowdSubsystem = World->GetSubsystem<UAriaCrowdSubsystem>();
+	TArray<FMassEntityHandle> Runners;
+	if (CrowdSubsystem)
+	{
+		CrowdSubsystem->SpawnRunners(CharacterClass, Locations, 1.f, Runners);
+	}
+
+	const double RunnerMs = TickFrames(World, Frames, [] {});
+
+	UE_LOG(LogAriaCrowdBenchmark, Display, TEXT("%d characters: %.3f ms/frame, %d runners: %.3f ms/frame, empty level: %.3f ms/frame"),
+		Characters.Num(), CharacterMs, Runners.Num(), RunnerMs, EmptyMs);
+	if (Characters.Num() > 0 && Runners.Num() > 0)
+	{
+		UE_LOG(LogAriaCrowdBenchmark, Display, TEXT("Per agent: character %.2f us, runner %.2f us"),
+			(CharacterMs - EmptyMs) * 1000.0 / Characters.Num(), (RunnerMs - EmptyMs) * 1000.0 / Runners.Num());
+	}
+
+	if (CrowdSubsystem)
+	{
+		CrowdSubsystem->DestroyRunners(Runners);
+	}
+
+	World->CleanupWorld();
+	World->RemoveFromRoot();
+	return 0;
+}
@@ -0,0 +1,285 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Commandlet/AriaMovementBenchmarkCommandlet.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Commandlet/AriaBenchmarkCourse.h"
+#include "Engine/StaticMesh.h"
+#include "Game/AriaPlayerController.h"
+#include "HAL/MemoryBase.h"
+#include "Manager/AriaPlayerCameraManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY(LogAriaMovementBenchmark);
+
+namespace AriaMovementBenchmark
+{
+	constexpr float FrameTime = 1.f / 60.f;
+	constexpr int32 WarmupFrames = 60;
+	constexpr int32 LatencyLanes = 8;
+	constexpr int32 LatencySettleFrames = 60;
+	constexpr int32 LatencyTimeoutFrames = 30;
+	constexpr float CameraMotionThreshold = .01f;
+
+	/**
+	 *	Forwards to the engine allocator and counts the allocations the game thread makes while counting is on
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		FMalloc* Inner = nullptr;
+		bool bCounting = false;
+		int64 Allocations = 0;
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->Malloc(Count, Alignment); }
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->TryMalloc(Count, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->Realloc(Original, Count, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override { CountAllocation(); return Inner->TryRealloc(Original, Count, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		void CountAllocation()
+		{
+			if (bCounting && IsInGameThread())
+			{
+				Allocations++;
+			}
+		}
+	};
+
+	/**
+	 *	Tick samples of one movement mode
+	 */
+	struct FModeSamples
+	{
+		TArray<double> Microseconds;
+		int64 SceneQueries = 0;
+		int64 Allocations = 0;
+	};
+
+	double GetPercentile(const TArray<double>& SortedValues, const float Percentile)
+	{
+		if (SortedValues.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		return SortedValues[FMath::Clamp(FMath::CeilToInt(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1)];
+	}
+
+	/**
+	 *	Frames from a move input at rest to the first frame the follow camera moves, 0 when it moves in the frame of the input.
+	 *	The player controller possesses the character and the world tick runs the movement and updates the camera like in game
+	 */
+	int32 MeasureCameraLatency(UWorld* World, APlayerController* PlayerController, AAriaCharacter* Character, UAriaCharacterMovement* Movement, const FVector& StartLocation, const FVector& Direction)
+	{
+		Movement->StopMovementImmediately();
+		Movement->SetMovementMode(MOVE_Falling);
+		Movement->bWantsToSlide = false;
+		Movement->bWantsToCrawling = false;
+		Movement->bWantsToDash = false;
+		Character->StopJumping();
+		Character->SetActorLocation(StartLocation, false, nullptr, ETeleportType::TeleportPhysics);
+
+		PlayerController->Possess(Character);
+		Movement->SetComponentTickEnabled(true);
+
+		int32 Latency = LatencyTimeoutFrames;
+		FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+		for (int32 Frame = 0; Frame < LatencySettleFrames + LatencyTimeoutFrames; Frame++)
+		{
+			const bool bPressed = Frame >= LatencySettleFrames;
+			if (bPressed)
+			{
+				Character->AddMovementInput(Direction);
+			}
+
+			Movement->bWantsToMove = bPressed;
+			World->Tick(LEVELTICK_All, FrameTime);
+			GFrameCounter++;
+
+			const FVector PreviousCameraLocation = CameraLocation;
+			CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+			if (bPressed && FMath::Abs(CameraLocation.X - PreviousCameraLocation.X) > CameraMotionThreshold)
+			{
+				Latency = Frame - LatencySettleFrames;
+				break;
+			}
+		}
+
+		Movement->SetComponentTickEnabled(false);
+		PlayerController->UnPossess();
+		return Latency;
+	}
+}
+
+UAriaMovementBenchmarkCommandlet::UAriaMovementBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAriaMovementBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace AriaMovementBenchmark;
+
+	FString CharacterClassName;
+	if (!FParse::Value(*Params, TEXT("Character="), CharacterClassName))
+	{
+		UE_LOG(LogAriaMovementBenchmark, Error, TEXT("Usage: -run=AriaMovementBenchmark -nullrhi -Character=<class path> [-Count=] [-Frames=] [-Seed=] [-Csv=]"));
+		return 1;
+	}
+
+	int32 Count = 32;
+	int32 Frames = 3600;
+	int32 Seed = 1;
+	FString CsvFilename = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("AriaMovementBenchmark.csv");
+	FParse::Value(*Params, TEXT("Count="), Count);
+	FParse::Value(*Params, TEXT("Frames="), Frames);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Csv="), CsvFilename);
+
+	UClass* CharacterClass = LoadClass<AAriaCharacter>(nullptr, *CharacterClassName);
+	const AAriaCharacter* CharacterDefaults = CharacterClass ? CharacterClass->GetDefaultObject<AAriaCharacter>() : nullptr;
+	const UAriaCharacterMovement* MovementDefaults = CharacterDefaults ? Cast<UAriaCharacterMovement>(CharacterDefaults->GetCharacterMovement()) : nullptr;
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!MovementDefaults || !Cube)
+	{
+		UE_LOG(LogAriaMovementBenchmark, Error, TEXT("Failed to load %s or the engine cube"), *CharacterClassName);
+		return 1;
+	}
+
+	UWorld* World = FAriaBenchmarkCourse::CreateWorld(TEXT("AriaMovementBenchmark"));
+
+	FAriaBenchmarkCourse Course;
+	Course.World = World;
+	Course.Cube = Cube;
+	Course.Movement = MovementDefaults;
+	Course.LaneCount = Count;
+	Course.Build(Seed);
+
+	TArray<AAriaCharacter*> Characters;
+	TArray<UAriaCharacterMovement*> Movements;
+	TArray<FVector> StartLocations;
+	for (int32 Lane = 0; Lane < Count; Lane++)
+	{
+		// the benchmark ticks the movement itself to time every tick
+		AAriaCharacter* Character = Course.SpawnCharacter(CharacterClass, Lane);
+		Characters.Add(Character);
+		Movements.Add(Cast<UAriaCharacterMovement>(Character->GetCharacterMovement()));
+		StartLocations.Add(Course.GetStartLocation(Lane));
+	}
+
+	// count the allocations of the movement ticks, the proxy outlives the run in case another thread still holds it
+	static FCountingMalloc CountingMalloc;
+	CountingMalloc.Inner = GMalloc;
+	GMalloc = &CountingMalloc;
+
+	TMap<FString, FModeSamples> Samples;
+	TArray<FAriaBenchmarkScript> Scripts;
+	for (int32 Lane = 0; Lane < Count; Lane++)
+	{
+		Scripts.Emplace(Seed * 7919 + Lane, StartLocations[Lane]);
+	}
+
+	for (int32 Frame = 0; Frame < Frames + WarmupFrames; Frame++)
+	{
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			AAriaCharacter* Character = Characters[Lane];
+			UAriaCharacterMovement* Movement = Movements[Lane];
+			Scripts[Lane].Step(Character, Movement, Frame, Course.EndX);
+
+			// the mode at the start of the tick owns the sample, a tick that starts a mantle counts as its own mode
+			FString ModeName = FAriaBenchmarkCourse::GetModeName(Movement);
+			const bool bHadRootMotion = Movement->HasRootMotionSources();
+
+			CountingMalloc.Allocations = 0;
+			CountingMalloc.bCounting = true;
+			const double StartTime = FPlatformTime::Seconds();
+			Movement->TickComponent(FrameTime, LEVELTICK_All, &Movement->PrimaryComponentTick);
+			const double TickSeconds = FPlatformTime::Seconds() - StartTime;
+			CountingMalloc.bCounting = false;
+
+			if (Frame < WarmupFrames)
+			{
+				continue;
+			}
+
+			if (!bHadRootMotion && Movement->HasRootMotionSources())
+			{
+				ModeName = TEXT("Mantle");
+			}
+
+			FModeSamples& ModeSamples = Samples.FindOrAdd(ModeName);
+			ModeSamples.Microseconds.Add(TickSeconds * 1000000.0);
+			ModeSamples.SceneQueries += Movement->GetSceneQueryCount();
+			ModeSamples.Allocations += CountingMalloc.Allocations;
+		}
+
+		World->Tick(LEVELTICK_All, FrameTime);
+		GFrameCounter++;
+	}
+
+	GMalloc = CountingMalloc.Inner;
+
+	// one press forward and one backward per lane, every lane starts on the flat landing segment
+	// there is no local player, the camera manager updates on its own like on a server without client side camera updates
+	APlayerController* PlayerController = World->SpawnActor<AAriaPlayerController>();
+	PlayerController->PlayerCameraManager->bUseClientSideCameraUpdates = false;
+
+	TArray<double> LatencyFrames;
+	for (int32 Lane = 0; Lane < FMath::Min(Count, LatencyLanes); Lane++)
+	{
+		LatencyFrames.Add(MeasureCameraLatency(World, PlayerController, Characters[Lane], Movements[Lane], StartLocations[Lane], FVector::ForwardVector));
+		LatencyFrames.Add(MeasureCameraLatency(World, PlayerController, Characters[Lane], Movements[Lane], StartLocations[Lane], FVector::BackwardVector));
+	}
+
+	Samples.KeySort(TLess<FString>());
+	FString Csv = FString::Printf(TEXT("# Seed=%d Count=%d Frames=%d\nMode,Ticks,P50Us,P90Us,P99Us,MaxUs,SceneQueriesPerTick,AllocationsPerTick\n"), Seed, Count, Frames);
+	UE_LOG(LogAriaMovementBenchmark, Display, TEXT("%-20s %8s %8s %8s %8s %8s %8s %8s"), TEXT("Mode"), TEXT("Ticks"), TEXT("P50us"), TEXT("P90us"), TEXT("P99us"), TEXT("MaxUs"), TEXT("Queries"), TEXT("Allocs"));
+	for (TPair<FString, FModeSamples>& Pair : Samples)
+	{
+		TArray<double>& Microseconds = Pair.Value.Microseconds;
+		Microseconds.Sort();
+		const int32 Ticks = Microseconds.Num();
+		const double P50 = GetPercentile(Microseconds, .5f);
+		const double P90 = GetPercentile(Microseconds, .9f);
+		const double P99 = GetPercentile(Microseconds, .99f);
+		const double Max = Microseconds.Last();
+		const double QueriesPerTick = static_cast<double>(Pair.Value.SceneQueries) / Ticks;
+		const double AllocationsPerTick = static_cast<double>(Pair.Value.Allocations) / Ticks;
+		UE_LOG(LogAriaMovementBenchmark, Display, TEXT("%-20s %8d %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f"), *Pair.Key, Ticks, P50, P90, P99, Max, QueriesPerTick, AllocationsPerTick);
+		Csv += FString::Printf(TEXT("%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"), *Pair.Key, Ticks, P50, P90, P99, Max, QueriesPerTick, AllocationsPerTick);
+	}
+
+	LatencyFrames.Sort();
+	const double LatencyP50 = GetPercentile(LatencyFrames, .5f);
+	const double LatencyMax = LatencyFrames.IsEmpty() ? 0.0 : LatencyFrames.Last();
+	UE_LOG(LogAriaMovementBenchmark, Display, TEXT("Input to camera latency over %d presses: P50 %.0f frames (%.2f ms), max %.0f frames (%.2f ms)"),
+		LatencyFrames.Num(), LatencyP50, LatencyP50 * FrameTime * 1000.0, LatencyMax, LatencyMax * FrameTime * 1000.0);
+	Csv += FString::Printf(TEXT("\nLatency,Presses,P50Frames,MaxFrames,P50Ms,MaxMs\nInputToCamera,%d,%.0f,%.0f,%.3f,%.3f\n"),
+		LatencyFrames.Num(), LatencyP50, LatencyMax, LatencyP50 * FrameTime * 1000.0, LatencyMax * FrameTime * 1000.0);
+
+	FAriaBenchmarkCourse::DestroyWorld(World);
+
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvFilename))
+	{
+		UE_LOG(LogAriaMovementBenchmark, Error, TEXT("Failed to write %s"), *CsvFilename);
+		return 1;
+	}
+
+	UE_LOG(LogAriaMovementBenchmark, Display, TEXT("Wrote %s"), *CsvFilename);
+	return 0;
+}
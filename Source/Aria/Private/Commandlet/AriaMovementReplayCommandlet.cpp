@@ -0,0 +1,160 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Commandlet/AriaMovementReplayCommandlet.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Manager/AriaMovementSubsystem.h"
+#include "Misc/FileHelper.h"
+#include "Utils/AriaMovementRecording.h"
+
+DEFINE_LOG_CATEGORY(LogAriaMovementReplay);
+
+namespace AriaMovementReplay
+{
+	FString GetModeName(const uint8 MovementMode, const uint8 CustomMovementMode)
+	{
+		if (MovementMode == MOVE_Custom)
+		{
+			return StaticEnum<ECustomMovementMode>()->GetNameStringByValue(CustomMovementMode);
+		}
+
+		return StaticEnum<EMovementMode>()->GetNameStringByValue(MovementMode);
+	}
+}
+
+UAriaMovementReplayCommandlet::UAriaMovementReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAriaMovementReplayCommandlet::Main(const FString& Params)
+{
+	using namespace AriaMovementReplay;
+	using EIntent = FAriaMovementRecordFrame::EIntent;
+
+	FString RecordingFilename;
+	if (!FParse::Value(*Params, TEXT("Recording="), RecordingFilename))
+	{
+		UE_LOG(LogAriaMovementReplay, Error, TEXT("Usage: -run=AriaMovementReplay -nullrhi -Recording=<file> [-Tolerance=] [-Csv=]"));
+		return 1;
+	}
+
+	float Tolerance = 1.f;
+	FString CsvFilename;
+	FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+	FParse::Value(*Params, TEXT("Csv="), CsvFilename);
+
+	FAriaMovementRecordHeader Header;
+	TArray<FAriaMovementRecordFrame> Frames;
+	if (!FAriaMovementRecordReader::Load(RecordingFilename, Header, Frames))
+	{
+		UE_LOG(LogAriaMovementReplay, Error, TEXT("Failed to read recording %s"), *RecordingFilename);
+		return 1;
+	}
+
+	UClass* CharacterClass = LoadClass<AAriaCharacter>(nullptr, *Header.CharacterClass);
+	UPackage* MapPackage = LoadPackage(nullptr, *Header.MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (!CharacterClass || !World)
+	{
+		UE_LOG(LogAriaMovementReplay, Error, TEXT("Failed to load %s or %s"), *Header.CharacterClass, *Header.MapName);
+		return 1;
+	}
+
+	// play the recorded level so movable actors and volumes behave like they did
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+	World->InitWorld(UWorld::InitializationValues().AllowAudioPlayback(false).CreatePhysicsScene(true).CreateNavigation(false).CreateAISystem(false));
+	World->UpdateWorldComponents(true, false);
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	const FTransform Transform(Header.Rotation, Header.Location);
+	AAriaCharacter* Character = World->SpawnActorDeferred<AAriaCharacter>(CharacterClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	UAriaCharacterMovement* Movement = Cast<UAriaCharacterMovement>(Character->GetCharacterMovement());
+	Movement->bRunPhysicsWithNoController = true;
+	Movement->bEnableMovementLod = false;
+	Character->FinishSpawning(Transform);
+
+	// the replay ticks the movement itself to feed the recorded delta times and time every tick
+	if (UAriaMovementSubsystem* MovementSubsystem = World->GetSubsystem<UAriaMovementSubsystem>())
+	{
+		MovementSubsystem->UnregisterMovement(Movement);
+	}
+
+	Movement->SetComponentTickEnabled(false);
+	Movement->RestoreRecordedState(Header);
+
+	FString Csv = TEXT("Frame,DeltaTime,Mode,TickUs,LocationError\n");
+	TArray<double> Microseconds;
+	Microseconds.Reserve(Frames.Num());
+	int32 DivergentFrame = INDEX_NONE;
+	for (int32 Index = 0; Index < Frames.Num(); Index++)
+	{
+		const FAriaMovementRecordFrame& Frame = Frames[Index];
+		Character->AddMovementInput(FVector(Frame.InputVector), 1.f, true);
+		Movement->bWantsToMove = (Frame.Intents & EIntent::Move) != 0;
+		Movement->bWantsToSlide = (Frame.Intents & EIntent::Slide) != 0;
+		Movement->bWantsToCrawling = (Frame.Intents & EIntent::Crawl) != 0;
+		Movement->bWantsToDash = (Frame.Intents & EIntent::Dash) != 0;
+		Movement->bWantsToCrouch = (Frame.Intents & EIntent::Crouch) != 0;
+		if (Frame.Intents & EIntent::Jump)
+		{
+			Character->Jump();
+		}
+		else
+		{
+			Character->StopJumping();
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		Movement->TickComponent(Frame.DeltaTime, LEVELTICK_All, &Movement->PrimaryComponentTick);
+		const double TickMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1000000.0;
+		Microseconds.Add(TickMicroseconds);
+
+		const FVector Location = Character->GetActorLocation();
+		const double LocationError = FVector::Dist(Location, Frame.Location);
+		if (DivergentFrame == INDEX_NONE && (LocationError > Tolerance || FVector::Dist(Movement->Velocity, Frame.Velocity) > Tolerance
+			|| Movement->MovementMode != Frame.MovementMode || (Movement->MovementMode == MOVE_Custom && Movement->CustomMovementMode != Frame.CustomMovementMode)))
+		{
+			DivergentFrame = Index;
+			UE_LOG(LogAriaMovementReplay, Warning, TEXT("Tick %d diverged: recorded %s at %s velocity %s, replayed %s at %s velocity %s"), Index,
+				*GetModeName(Frame.MovementMode, Frame.CustomMovementMode), *Frame.Location.ToString(), *Frame.Velocity.ToString(),
+				*GetModeName(Movement->MovementMode, Movement->CustomMovementMode), *Location.ToString(), *Movement->Velocity.ToString());
+		}
+
+		Csv += FString::Printf(TEXT("%d,%.6f,%s,%.3f,%.3f\n"), Index, Frame.DeltaTime, *GetModeName(Movement->MovementMode, Movement->CustomMovementMode), TickMicroseconds, LocationError);
+
+		World->Tick(LEVELTICK_All, Frame.DeltaTime);
+		GFrameCounter++;
+	}
+
+	Microseconds.Sort();
+	const auto GetPercentile = [&Microseconds](const float Percentile)
+	{
+		return Microseconds.IsEmpty() ? 0.0 : Microseconds[FMath::Clamp(FMath::CeilToInt(Percentile * Microseconds.Num()) - 1, 0, Microseconds.Num() - 1)];
+	};
+
+	UE_LOG(LogAriaMovementReplay, Display, TEXT("Replayed %d ticks of %s: p50 %.2f us, p99 %.2f us, max %.2f us"),
+		Frames.Num(), *RecordingFilename, GetPercentile(.5f), GetPercentile(.99f), GetPercentile(1.f));
+	if (DivergentFrame == INDEX_NONE)
+	{
+		UE_LOG(LogAriaMovementReplay, Display, TEXT("Replay matches the recording within %.2f units"), Tolerance);
+	}
+
+	World->CleanupWorld();
+	World->RemoveFromRoot();
+
+	if (!CsvFilename.IsEmpty() && !FFileHelper::SaveStringToFile(Csv, *CsvFilename))
+	{
+		UE_LOG(LogAriaMovementReplay, Error, TEXT("Failed to write %s"), *CsvFilename);
+		return 1;
+	}
+
+	return DivergentFrame == INDEX_NONE ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Commandlet/AriaNetBandwidthCommandlet.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Commandlet/AriaBenchmarkCourse.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/BitWriter.h"
+
+DEFINE_LOG_CATEGORY(LogAriaNetBandwidth);
+
+namespace AriaNetBandwidth
+{
+	/**
+	 *	Bits of the traversal state sent while in one mode and the seconds spent in it
+	 */
+	struct FModeBits
+	{
+		int64 ClientBits = 0;
+		int64 ProxyBits = 0;
+		double Seconds = 0.0;
+	};
+
+	int64 GetStateBits(FAriaReplicatedModeState State)
+	{
+		FBitWriter Writer(0, true);
+		bool bSuccess = true;
+		State.NetSerialize(Writer, nullptr, bSuccess);
+		return Writer.GetNumBits();
+	}
+}
+
+UAriaNetBandwidthCommandlet::UAriaNetBandwidthCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAriaNetBandwidthCommandlet::Main(const FString& Params)
+{
+	using namespace AriaNetBandwidth;
+
+	FString CharacterClassName;
+	if (!FParse::Value(*Params, TEXT("Character="), CharacterClassName))
+	{
+		UE_LOG(LogAriaNetBandwidth, Error, TEXT("Usage: -run=AriaNetBandwidth -nullrhi -Character=<class path> [-Count=] [-Seconds=] [-MoveRate=] [-UpdateRate=] [-Seed=] [-Csv=]"));
+		return 1;
+	}
+
+	int32 Count = 8;
+	float Seconds = 60.f;
+	float MoveRate = 60.f;
+	float UpdateRate = 30.f;
+	int32 Seed = 1;
+	FString CsvFilename;
+	FParse::Value(*Params, TEXT("Count="), Count);
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FParse::Value(*Params, TEXT("MoveRate="), MoveRate);
+	FParse::Value(*Params, TEXT("UpdateRate="), UpdateRate);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Csv="), CsvFilename);
+
+	UClass* CharacterClass = LoadClass<AAriaCharacter>(nullptr, *CharacterClassName);
+	const AAriaCharacter* CharacterDefaults = CharacterClass ? CharacterClass->GetDefaultObject<AAriaCharacter>() : nullptr;
+	const UAriaCharacterMovement* MovementDefaults = CharacterDefaults ? Cast<UAriaCharacterMovement>(CharacterDefaults->GetCharacterMovement()) : nullptr;
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!MovementDefaults || !Cube)
+	{
+		UE_LOG(LogAriaNetBandwidth, Error, TEXT("Failed to load %s or the engine cube"), *CharacterClassName);
+		return 1;
+	}
+
+	UWorld* World = FAriaBenchmarkCourse::CreateWorld(TEXT("AriaNetBandwidth"));
+
+	FAriaBenchmarkCourse Course;
+	Course.World = World;
+	Course.Cube = Cube;
+	Course.Movement = MovementDefaults;
+	Course.LaneCount = Count;
+	Course.Build(Seed);
+
+	TArray<AAriaCharacter*> Characters;
+	TArray<UAriaCharacterMovement*> Movements;
+	TArray<FAriaBenchmarkScript> Scripts;
+	TArray<FAriaReplicatedModeState> ProxyStates;
+	for (int32 Lane = 0; Lane < Count; Lane++)
+	{
+		AAriaCharacter* Character = Course.SpawnCharacter(CharacterClass, Lane);
+		Characters.Add(Character);
+		Movements.Add(Cast<UAriaCharacterMovement>(Character->GetCharacterMovement()));
+		Scripts.Emplace(Seed * 7919 + Lane, Course.GetStartLocation(Lane));
+		ProxyStates.AddDefaulted();
+	}
+
+	// every move sends the state of the simulation to the server, proxies only receive it when it changed since their last update
+	const float MoveTime = 1.f / MoveRate;
+	const int32 MovesPerUpdate = FMath::Max(FMath::RoundToInt(MoveRate / UpdateRate), 1);
+	const int32 Moves = FMath::CeilToInt(Seconds * MoveRate);
+	TMap<FString, FModeBits> Bits;
+	for (int32 Move = 0; Move < Moves; Move++)
+	{
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			UAriaCharacterMovement* Movement = Movements[Lane];
+			Scripts[Lane].Step(Characters[Lane], Movement, Move, Course.EndX);
+
+			// the mode at the start of the move owns the bits, a move that starts a mantle counts as its own mode
+			FString ModeName = FAriaBenchmarkCourse::GetModeName(Movement);
+			const bool bHadRootMotion = Movement->HasRootMotionSources();
+			Movement->TickComponent(MoveTime, LEVELTICK_All, &Movement->PrimaryComponentTick);
+			if (!bHadRootMotion && Movement->HasRootMotionSources())
+			{
+				ModeName = TEXT("Mantle");
+			}
+
+			const FAriaReplicatedModeState State = Movement->MakeReplicatedModeState();
+			FModeBits& ModeBits = Bits.FindOrAdd(ModeName);
+			ModeBits.ClientBits += GetStateBits(State);
+			ModeBits.Seconds += MoveTime;
+			if (Move % MovesPerUpdate == 0 && State != ProxyStates[Lane])
+			{
+				ModeBits.ProxyBits += GetStateBits(State);
+				ProxyStates[Lane] = State;
+			}
+		}
+
+		World->Tick(LEVELTICK_All, MoveTime);
+		GFrameCounter++;
+	}
+
+	FAriaBenchmarkCourse::DestroyWorld(World);
+
+	Bits.KeySort(TLess<FString>());
+	FString Csv = FString::Printf(TEXT("# Seed=%d Count=%d Seconds=%.1f MoveRate=%.1f UpdateRate=%.1f\nMode,Seconds,ClientToServerBytesPerSecond,ServerToProxyBytesPerSecond\n"), Seed, Count, Seconds, MoveRate, UpdateRate);
+	UE_LOG(LogAriaNetBandwidth, Display, TEXT("%-20s %10s %16s %16s"), TEXT("Mode"), TEXT("Seconds"), TEXT("Client->Server"), TEXT("Server->Proxy"));
+	for (const TPair<FString, FModeBits>& Pair : Bits)
+	{
+		// per character, over the time spent in the mode
+		const double ClientBytesPerSecond = Pair.Value.ClientBits / 8.0 / Pair.Value.Seconds;
+		const double ProxyBytesPerSecond = Pair.Value.ProxyBits / 8.0 / Pair.Value.Seconds;
+		UE_LOG(LogAriaNetBandwidth, Display, TEXT("%-20s %10.2f %12.1f B/s %12.1f B/s"), *Pair.Key, Pair.Value.Seconds, ClientBytesPerSecond, ProxyBytesPerSecond);
+		Csv += FString::Printf(TEXT("%s,%.3f,%.2f,%.2f\n"), *Pair.Key, Pair.Value.Seconds, ClientBytesPerSecond, ProxyBytesPerSecond);
+	}
+
+	if (!CsvFilename.IsEmpty() && !FFileHelper::SaveStringToFile(Csv, *CsvFilename))
+	{
+		UE_LOG(LogAriaNetBandwidth, Error, TEXT("Failed to write %s"), *CsvFilename);
+		return 1;
+	}
+
+	return 0;
+}
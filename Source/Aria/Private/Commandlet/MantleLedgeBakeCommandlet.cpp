@@ -0,0 +1,175 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Commandlet/MantleLedgeBakeCommandlet.h"
+#include "EngineUtils.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/PlayerStart.h"
+#include "Manager/MantleLedgeSubsystem.h"
+#include "Utils/MantleLedgeDatabase.h"
+
+DEFINE_LOG_CATEGORY(LogMantleLedgeBake);
+
+UMantleLedgeBakeCommandlet::UMantleLedgeBakeCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UMantleLedgeBakeCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	FString CharacterClassName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName) || !FParse::Value(*Params, TEXT("Character="), CharacterClassName))
+	{
+		UE_LOG(LogMantleLedgeBake, Error, TEXT("Usage: -run=MantleLedgeBake -Map=<package> -Character=<class path> [-PlaneY=] [-Step=] [-CellSize=]"));
+		return 1;
+	}
+
+	// the character defaults provide the capsule and the mantle thresholds
+	const UClass* CharacterClass = LoadClass<AAriaCharacter>(nullptr, *CharacterClassName);
+	if (!CharacterClass)
+	{
+		UE_LOG(LogMantleLedgeBake, Error, TEXT("Failed to load character class %s"), *CharacterClassName);
+		return 1;
+	}
+
+	const AAriaCharacter* CharacterDefaults = CharacterClass->GetDefaultObject<AAriaCharacter>();
+	const UAriaCharacterMovement* MovementDefaults = Cast<UAriaCharacterMovement>(CharacterDefaults->GetCharacterMovement());
+	if (!MovementDefaults)
+	{
+		UE_LOG(LogMantleLedgeBake, Error, TEXT("%s has no aria character movement"), *CharacterClassName);
+		return 1;
+	}
+
+	const float CapsuleRadius = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+	const float CapsuleHalfHeight = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+	const float CheckDistance = FMath::Max(MovementDefaults->MaxFrontMantleCheckDistance, CapsuleRadius + 30.f);
+	const FAriaMantleQuery Query = MovementDefaults->MakeMantleQuery();
+
+	// load the level with collision
+	UPackage* MapPackage = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogMantleLedgeBake, Error, TEXT("Failed to load map %s"), *MapName);
+		return 1;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+	World->InitWorld(UWorld::InitializationValues().AllowAudioPlayback(false).CreatePhysicsScene(true).CreateNavigation(false).CreateAISystem(false));
+	World->UpdateWorldComponents(true, false);
+
+	// the game plays on one XZ plane, default to the player start depth
+	float PlaneY = 0.f;
+	if (!FParse::Value(*Params, TEXT("PlaneY="), PlaneY))
+	{
+		if (TActorIterator<APlayerStart> PlayerStart(World); PlayerStart)
+		{
+			PlaneY = PlayerStart->GetActorLocation().Y;
+		}
+	}
+
+	float Step = 10.f;
+	float CellSize = 200.f;
+	FParse::Value(*Params, TEXT("Step="), Step);
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+
+	// sample the static collision that crosses the play plane, anything that can move is probed at runtime
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MantleLedgeBake), false);
+	FBox Bounds(ForceInit);
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		It->ForEachComponent<UPrimitiveComponent>(false, [&Bounds, &QueryParams, PlaneY](const UPrimitiveComponent* Component)
+		{
+			if (Component->Mobility != EComponentMobility::Static)
+			{
+				QueryParams.AddIgnoredComponent(Component);
+				return;
+			}
+
+			const FBox ComponentBounds = Component->Bounds.GetBox();
+			if (Component->IsCollisionEnabled() && ComponentBounds.Min.Y <= PlaneY && ComponentBounds.Max.Y >= PlaneY && ComponentBounds.GetSize().GetMax() < UE_OLD_HALF_WORLD_MAX)
+			{
+				Bounds += ComponentBounds;
+			}
+		});
+	}
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogMantleLedgeBake, Error, TEXT("No collision crosses the play plane Y=%.1f"), PlaneY);
+		World->RemoveFromRoot();
+		return 1;
+	}
+
+	Bounds = Bounds.ExpandBy(CheckDistance + Query.ReachHeight);
+
+	const FCollisionShape CapShape = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
+	TArray<FMantleLedgeRecord> Records;
+	TMap<TPair<FIntVector, int32>, int32> RecordIndices;
+
+	for (float Z = Bounds.Min.Z; Z <= Bounds.Max.Z; Z += Step)
+	{
+		for (float X = Bounds.Min.X; X <= Bounds.Max.X; X += Step)
+		{
+			for (const float Facing : { 1.f, -1.f })
+			{
+				// same checks as the runtime probe path
+				const FVector FrontStart(X, PlaneY, Z);
+				const FVector ForwardVector(Facing, 0.f, 0.f);
+				FHitResult FrontResult;
+				if (!World->LineTraceSingleByProfile(FrontResult, FrontStart, FrontStart + ForwardVector * CheckDistance, "BlockAll", QueryParams) || FrontResult.bStartPenetrating)
+				{
+					continue;
+				}
+
+				FAriaMantleLedge Ledge;
+				if (!UAriaCharacterMovement::IsMantleWall(Query, FrontResult, ForwardVector) || !UAriaCharacterMovement::FindMantleLedge(World, QueryParams, Query, FrontResult, FrontStart, ForwardVector, CapsuleRadius, CapsuleHalfHeight, Ledge))
+				{
+					continue;
+				}
+
+				if (World->OverlapAnyTestByProfile(Ledge.Target, FQuat::Identity, "BlockAll", CapShape, QueryParams))
+				{
+					continue;
+				}
+
+				// samples reaching the same ledge widen its reach range
+				const TPair<FIntVector, int32> Key(FIntVector(FMath::RoundToInt32(Ledge.Surface.X / Step), FMath::RoundToInt32(Ledge.Surface.Y / Step), FMath::RoundToInt32(Ledge.Surface.Z / Step)), Facing > 0.f ? 1 : -1);
+				if (const int32* Index = RecordIndices.Find(Key))
+				{
+					FMantleLedgeRecord& Record = Records[*Index];
+					Record.MinReachZ = FMath::Min(Record.MinReachZ, Z - Step * 0.5f);
+					Record.MaxReachZ = FMath::Max(Record.MaxReachZ, Z + Step * 0.5f);
+					continue;
+				}
+
+				FMantleLedgeRecord& Record = Records.AddZeroed_GetRef();
+				Record.Surface = FVector3f(Ledge.Surface);
+				Record.Target = FVector3f(Ledge.Target);
+				FMantleLedgeRecord::PackNormal(Ledge.WallNormal, Record.WallNormal);
+				FMantleLedgeRecord::PackNormal(Ledge.SurfaceNormal, Record.SurfaceNormal);
+				Record.MinReachZ = Z - Step * 0.5f;
+				Record.MaxReachZ = Z + Step * 0.5f;
+				RecordIndices.Add(Key, Records.Num() - 1);
+			}
+		}
+	}
+
+	World->RemoveFromRoot();
+
+	const FString Filename = UMantleLedgeSubsystem::GetLedgeFilename(MapPackage->GetName());
+	if (!FMantleLedgeDatabase::Save(Filename, Records, CellSize))
+	{
+		UE_LOG(LogMantleLedgeBake, Error, TEXT("Failed to write %s"), *Filename);
+		return 1;
+	}
+
+	UE_LOG(LogMantleLedgeBake, Display, TEXT("Baked %d ledges into %s (%.1f KB)"), Records.Num(), *Filename, Records.Num() * sizeof(FMantleLedgeRecord) / 1024.f);
+	return 0;
+}
@@ -0,0 +1,63 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Crowd/AriaCrowdFragments.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Components/CapsuleComponent.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+
+FAriaCrowdTraversalParams FAriaCrowdTraversalParams::MakeFromCharacter(const TSubclassOf<AAriaCharacter> CharacterClass)
+{
+	FAriaCrowdTraversalParams Params;
+	const AAriaCharacter* CharacterDefaults = CharacterClass ? CharacterClass->GetDefaultObject<AAriaCharacter>() : nullptr;
+	const UAriaCharacterMovement* Movement = CharacterDefaults ? Cast<UAriaCharacterMovement>(CharacterDefaults->GetCharacterMovement()) : nullptr;
+	if (!Movement)
+	{
+		return Params;
+	}
+
+	Params.CapsuleRadius = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+	Params.CapsuleHalfHeight = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+	Params.GravityZ = UPhysicsSettings::Get()->DefaultGravityZ * Movement->GravityScale;
+	Params.MaxRunSpeed = Movement->MaxWalkSpeed;
+	Params.RunAcceleration = Movement->MaxAcceleration;
+	Params.BrakingFrictionFactor = Movement->BrakingFrictionFactor;
+	Params.bUseSeparateBrakingFriction = Movement->bUseSeparateBrakingFriction;
+	Params.BrakingFriction = Movement->BrakingFriction;
+	Params.BrakingSubStepTime = Movement->BrakingSubStepTime;
+	Params.MinHeightToSlide = Movement->MinHeightToSlide;
+	Params.WallSlideGravityCurve = Movement->WallSlideGravityCurve;
+	Params.MinSpeedToEnterSlide = Movement->MinSpeedToEnterSlide;
+	Params.EnterSlideImpulse = Movement->EnterSlideImpulse;
+	Params.SlideFriction = Movement->SlideFriction;
+	Params.MaxSlidingSeconds = Movement->MaxSlidingSeconds;
+	Params.ForwardDistanceToCheckLadder = Movement->ForwardDistanceToCheckLadder;
+	Params.MaxClimbLadderSpeed = Movement->MaxClimbLadderSpeed;
+	Params.IceSlideFriction = Movement->IceSlideFriction;
+	Params.IceSlidingBrakingFrictionFactor = Movement->IceSlidingBrakingFrictionFactor;
+	Params.MaxIceSlidingAcceleration = Movement->MaxIceSlidingAcceleration;
+	Params.MaxIceSlidingSpeed = Movement->MaxIceSlidingSpeed;
+	Params.bClassifySurfacesByTag = Movement->bClassifySurfacesByTag;
+	Params.RopeTag = Movement->RopeTag;
+	Params.ClimbLadderTag = Movement->ClimbLadderTag;
+	Params.IceTag = Movement->IceTag;
+	Params.MovableTag = Movement->MovableTag;
+	return Params;
+}
+
+EAriaSurfaceKind FAriaCrowdTraversalParams::ClassifySurface(const FHitResult& HitResult) const
+{
+	if (!HitResult.bBlockingHit)
+	{
+		return EAriaSurfaceKind::None;
+	}
+
+	bool bHasSurfaceMaterial;
+	const EAriaSurfaceKind SurfaceKind = UAriaPhysicalMaterial::GetSurfaceKinds(HitResult, bHasSurfaceMaterial);
+	if (bHasSurfaceMaterial || !bClassifySurfacesByTag)
+	{
+		return SurfaceKind;
+	}
+
+	return UAriaPhysicalMaterial::GetTaggedSurfaceKinds(HitResult.GetActor(), RopeTag, ClimbLadderTag, IceTag, MovableTag);
+}
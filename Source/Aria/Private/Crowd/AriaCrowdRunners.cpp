@@ -0,0 +1,80 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Crowd/AriaCrowdRunners.h"
+#include "Character/AriaCharacter.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Manager/AriaCrowdSubsystem.h"
+
+AAriaCrowdRunners::AAriaCrowdRunners()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// runners probe the world but never block anything
+	MeshComponent = CreateDefaultSubobject<UInstancedStaticMeshComponent>("MeshComponent");
+	MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeshComponent->SetMobility(EComponentMobility::Movable);
+	SetRootComponent(MeshComponent);
+}
+
+void AAriaCrowdRunners::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UAriaCrowdSubsystem* CrowdSubsystem = GetWorld()->GetSubsystem<UAriaCrowdSubsystem>();
+	if (!CrowdSubsystem || !CharacterClass)
+	{
+		return;
+	}
+
+	TArray<FVector> SpawnLocations;
+	SpawnLocations.Reserve(Count);
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		SpawnLocations.Add(GetActorLocation() - FVector(Direction < 0.f ? -1.f : 1.f, 0.f, 0.f) * Spacing * Index);
+	}
+
+	CrowdSubsystem->SpawnRunners(CharacterClass, SpawnLocations, Direction, Runners);
+
+	InstanceTransforms.SetNum(Runners.Num());
+	MeshComponent->ClearInstances();
+	MeshComponent->AddInstances(InstanceTransforms, false, true);
+}
+
+void AAriaCrowdRunners::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UAriaCrowdSubsystem* CrowdSubsystem = GetWorld()->GetSubsystem<UAriaCrowdSubsystem>())
+	{
+		CrowdSubsystem->DestroyRunners(Runners);
+	}
+
+	Runners.Reset();
+	Super::EndPlay(EndPlayReason);
+}
+
+void AAriaCrowdRunners::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UAriaCrowdSubsystem* CrowdSubsystem = GetWorld()->GetSubsystem<UAriaCrowdSubsystem>();
+	if (!CrowdSubsystem || Runners.IsEmpty())
+	{
+		return;
+	}
+
+	// the runners keep the intent until they run fast enough on the ground to slide
+	SlideTime += DeltaTime;
+	if (SlideInterval > 0.f && SlideTime >= SlideInterval)
+	{
+		SlideTime = 0.f;
+		CrowdSubsystem->SetWantsToSlide(Runners, true);
+	}
+
+	CrowdSubsystem->GetRunnerLocations(Runners, RunnerLocations);
+	const FRotator Facing(0.f, Direction < 0.f ? 180.f : 0.f, 0.f);
+	for (int32 Index = 0; Index < RunnerLocations.Num(); Index++)
+	{
+		InstanceTransforms[Index] = FTransform(Facing, RunnerLocations[Index]);
+	}
+
+	MeshComponent->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true);
+}
@@ -0,0 +1,235 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Crowd/AriaCrowdTraversalProcessor.h"
+#include "MassExecutionContext.h"
+#include "Async/ParallelFor.h"
+#include "Character/AriaTraversalRules.h"
+#include "Crowd/AriaCrowdFragments.h"
+#include "Engine/World.h"
+#include "Utils/AriaStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Crowd Traversal"), STAT_AriaCrowdTraversal, STATGROUP_AriaMovement);
+
+namespace AriaCrowdTraversal
+{
+	void SetMode(FAriaCrowdModeFragment& Mode, const EAriaCrowdMode NewMode)
+	{
+		Mode.Mode = NewMode;
+		Mode.ModeTime = 0.f;
+	}
+
+	void UpdateMode(const FAriaCrowdTraversalParams& Params, const FAriaCrowdProbeFragment& Probe, FAriaCrowdModeFragment& Mode, FVector& Velocity, const float DeltaTime)
+	{
+		// same thresholds as the character predicates
+		const bool bIsGrounded = Probe.bHasFloor && Probe.FloorDistance <= Params.CapsuleHalfHeight + Params.CapsuleRadius;
+		const bool bHasSlideWall = Probe.bHasWall && Probe.WallDistance <= FAriaTraversalRules::GetWallSlideWallDistance(Params.CapsuleRadius);
+		const bool bHasSlideFloor = Probe.bHasFloor && Probe.FloorDistance <= FAriaTraversalRules::GetWallSlideFloorDistance(Params.CapsuleRadius, Params.MinHeightToSlide);
+		const bool bHasLadder = Probe.bHasWall && Probe.WallDistance <= Params.ForwardDistanceToCheckLadder && EnumHasAnyFlags(Probe.WallSurface, EAriaSurfaceKind::Ladder);
+		const bool bIsOnIce = bIsGrounded && EnumHasAnyFlags(Probe.FloorSurface, EAriaSurfaceKind::Ice);
+
+		Mode.ModeTime += DeltaTime;
+		switch (Mode.Mode)
+		{
+			case EAriaCrowdMode::Running:
+				if (!bIsGrounded)
+				{
+					SetMode(Mode, EAriaCrowdMode::Falling);
+				}
+				else if (bIsOnIce)
+				{
+					SetMode(Mode, EAriaCrowdMode::IceSliding);
+				}
+				else if (bHasLadder)
+				{
+					SetMode(Mode, EAriaCrowdMode::ClimbLadder);
+				}
+				else if (Mode.bWantsToSlide && Velocity.SizeSquared() > FMath::Square(Params.MinSpeedToEnterSlide))
+				{
+					Velocity = FAriaTraversalRules::GetEnterSlideVelocity(Velocity, Params.EnterSlideImpulse);
+					SetMode(Mode, EAriaCrowdMode::Sliding);
+				}
+				break;
+			case EAriaCrowdMode::Falling:
+				if (bIsGrounded && Velocity.Z <= 0.f)
+				{
+					Velocity.Z = 0.f;
+					SetMode(Mode, EAriaCrowdMode::Running);
+				}
+				else if (bHasLadder)
+				{
+					SetMode(Mode, EAriaCrowdMode::ClimbLadder);
+				}
+				else if (bHasSlideWall && !bHasSlideFloor && Params.WallSlideGravityCurve)
+				{
+					SetMode(Mode, EAriaCrowdMode::WallSliding);
+				}
+				break;
+			case EAriaCrowdMode::WallSliding:
+				if (!FAriaTraversalRules::CanKeepWallSliding(bHasSlideWall, bHasSlideFloor))
+				{
+					SetMode(Mode, EAriaCrowdMode::Falling);
+				}
+				break;
+			case EAriaCrowdMode::Sliding:
+				if (!bIsGrounded || FAriaTraversalRules::HasSlideExpired(Mode.ModeTime, Params.MaxSlidingSeconds))
+				{
+					Mode.bWantsToSlide = false;
+					SetMode(Mode, bIsGrounded ? EAriaCrowdMode::Running : EAriaCrowdMode::Falling);
+				}
+				break;
+			case EAriaCrowdMode::ClimbLadder:
+				if (!bHasLadder)
+				{
+					SetMode(Mode, EAriaCrowdMode::Falling);
+				}
+				break;
+			case EAriaCrowdMode::IceSliding:
+				if (!bIsOnIce)
+				{
+					SetMode(Mode, bIsGrounded ? EAriaCrowdMode::Running : EAriaCrowdMode::Falling);
+				}
+				break;
+		}
+	}
+
+	void UpdateVelocity(const FAriaCrowdTraversalParams& Params, const FAriaCrowdProbeFragment& Probe, const FAriaCrowdModeFragment& Mode, FVector& Velocity, const float DeltaTime)
+	{
+		const float TargetSpeed = Mode.Direction * Params.MaxRunSpeed;
+		switch (Mode.Mode)
+		{
+			case EAriaCrowdMode::Running:
+				Velocity.X = FMath::FInterpConstantTo(Velocity.X, TargetSpeed, DeltaTime, Params.RunAcceleration);
+				Velocity.Z = 0.f;
+				break;
+			case EAriaCrowdMode::Falling:
+				Velocity.Z += Params.GravityZ * DeltaTime;
+				break;
+			case EAriaCrowdMode::WallSliding:
+				Velocity = FAriaTraversalRules::GetWallSlideVelocity(Velocity, Probe.WallNormal, FVector::ZeroVector, Params.GravityZ, Params.WallSlideGravityCurve, DeltaTime);
+				break;
+			case EAriaCrowdMode::Sliding:
+				// custom modes have no braking deceleration, like the hero's
+				Velocity = FAriaTraversalRules::GetVelocity(Velocity, FVector::ZeroVector, 0.f, Params.SlideFriction, true, Params.GetBrakingFriction(Params.SlideFriction) * Params.BrakingFrictionFactor, 0.f, Params.BrakingSubStepTime, DeltaTime);
+				Velocity.Z = 0.f;
+				break;
+			case EAriaCrowdMode::ClimbLadder:
+				Velocity = FAriaTraversalRules::GetClimbLadderVelocity(Velocity, Probe.WallNormal, Params.MaxClimbLadderSpeed, 1.f);
+				break;
+			case EAriaCrowdMode::IceSliding:
+			{
+				// runners always push forward
+				const FVector Acceleration(Mode.Direction * Params.MaxIceSlidingAcceleration, 0.f, 0.f);
+				const float BrakingFriction = Params.GetBrakingFriction(Params.IceSlideFriction) * Params.IceSlidingBrakingFrictionFactor;
+				Velocity = FAriaTraversalRules::GetVelocity(Velocity, Acceleration, Params.MaxIceSlidingSpeed, Params.IceSlideFriction, false, BrakingFriction, 0.f, Params.BrakingSubStepTime, DeltaTime);
+				Velocity.Z = 0.f;
+				break;
+			}
+		}
+
+		// runners don't sweep, stop them in front of the probed wall instead
+		if (Probe.bHasWall && Velocity.X * Mode.Direction > 0.f && Probe.WallDistance - Params.CapsuleRadius <= FMath::Abs(Velocity.X) * DeltaTime)
+		{
+			Velocity.X = 0.f;
+		}
+	}
+}
+
+UAriaCrowdTraversalProcessor::UAriaCrowdTraversalProcessor()
+	: ProbeQuery(*this)
+	, TraversalQuery(*this)
+{
+	// the crowd subsystem runs the processor itself
+	bAutoRegisterWithProcessingPhases = false;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+}
+
+void UAriaCrowdTraversalProcessor::ConfigureQueries()
+{
+	ProbeQuery.AddRequirement<FAriaCrowdLocationFragment>(EMassFragmentAccess::ReadOnly);
+	ProbeQuery.AddRequirement<FAriaCrowdModeFragment>(EMassFragmentAccess::ReadOnly);
+	ProbeQuery.AddRequirement<FAriaCrowdProbeFragment>(EMassFragmentAccess::ReadWrite);
+	ProbeQuery.AddConstSharedRequirement<FAriaCrowdTraversalParams>();
+
+	TraversalQuery.AddRequirement<FAriaCrowdLocationFragment>(EMassFragmentAccess::ReadWrite);
+	TraversalQuery.AddRequirement<FAriaCrowdVelocityFragment>(EMassFragmentAccess::ReadWrite);
+	TraversalQuery.AddRequirement<FAriaCrowdModeFragment>(EMassFragmentAccess::ReadWrite);
+	TraversalQuery.AddRequirement<FAriaCrowdProbeFragment>(EMassFragmentAccess::ReadOnly);
+	TraversalQuery.AddConstSharedRequirement<FAriaCrowdTraversalParams>();
+}
+
+void UAriaCrowdTraversalProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	ARIA_MOVEMENT_SCOPE(CrowdTraversal);
+	using namespace AriaCrowdTraversal;
+
+	const UWorld* World = EntityManager.GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// probe phase, read-only scene queries spread over the worker threads
+	ProbeQuery.ForEachEntityChunk(EntityManager, Context, [World](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FAriaCrowdLocationFragment> Locations = ChunkContext.GetFragmentView<FAriaCrowdLocationFragment>();
+		const TConstArrayView<FAriaCrowdModeFragment> Modes = ChunkContext.GetFragmentView<FAriaCrowdModeFragment>();
+		const TArrayView<FAriaCrowdProbeFragment> Probes = ChunkContext.GetMutableFragmentView<FAriaCrowdProbeFragment>();
+		const FAriaCrowdTraversalParams& Params = ChunkContext.GetConstSharedFragment<FAriaCrowdTraversalParams>();
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AriaCrowdProbe), false);
+		QueryParams.bReturnPhysicalMaterial = true;
+		const float WallLength = FMath::Max(FAriaTraversalRules::GetWallSlideWallDistance(Params.CapsuleRadius), Params.ForwardDistanceToCheckLadder);
+		const float FloorLength = Params.CapsuleHalfHeight + FAriaTraversalRules::GetWallSlideFloorDistance(Params.CapsuleRadius, Params.MinHeightToSlide);
+
+		ParallelFor(ChunkContext.GetNumEntities(), [&](const int32 Index)
+		{
+			const FVector& Location = Locations[Index].Location;
+			FAriaCrowdProbeFragment& Probe = Probes[Index];
+
+			FHitResult WallHit;
+			Probe.bHasWall = World->LineTraceSingleByProfile(WallHit, Location, Location + FVector(Modes[Index].Direction * WallLength, 0.f, 0.f), "BlockAll", QueryParams);
+			Probe.WallDistance = WallHit.Distance;
+			Probe.WallNormal = WallHit.Normal;
+			Probe.WallSurface = Params.ClassifySurface(WallHit);
+
+			FHitResult FloorHit;
+			Probe.bHasFloor = World->LineTraceSingleByProfile(FloorHit, Location, Location - FVector(0.f, 0.f, FloorLength), "BlockAll", QueryParams);
+			Probe.FloorDistance = FloorHit.Distance;
+			Probe.FloorSurface = Params.ClassifySurface(FloorHit);
+		});
+	});
+
+	// rules and integration over the contiguous chunk arrays
+	const float DeltaTime = Context.GetDeltaTimeSeconds();
+	TraversalQuery.ForEachEntityChunk(EntityManager, Context, [DeltaTime](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FAriaCrowdLocationFragment> Locations = ChunkContext.GetMutableFragmentView<FAriaCrowdLocationFragment>();
+		const TArrayView<FAriaCrowdVelocityFragment> Velocities = ChunkContext.GetMutableFragmentView<FAriaCrowdVelocityFragment>();
+		const TArrayView<FAriaCrowdModeFragment> Modes = ChunkContext.GetMutableFragmentView<FAriaCrowdModeFragment>();
+		const TConstArrayView<FAriaCrowdProbeFragment> Probes = ChunkContext.GetFragmentView<FAriaCrowdProbeFragment>();
+		const FAriaCrowdTraversalParams& Params = ChunkContext.GetConstSharedFragment<FAriaCrowdTraversalParams>();
+		const int32 NumEntities = ChunkContext.GetNumEntities();
+
+		for (int32 Index = 0; Index < NumEntities; Index++)
+		{
+			UpdateMode(Params, Probes[Index], Modes[Index], Velocities[Index].Velocity, DeltaTime);
+			UpdateVelocity(Params, Probes[Index], Modes[Index], Velocities[Index].Velocity, DeltaTime);
+		}
+
+		// branch-free integration the compiler can vectorize
+		for (int32 Index = 0; Index < NumEntities; Index++)
+		{
+			Locations[Index].Location += Velocities[Index].Velocity * DeltaTime;
+		}
+
+		// keep grounded runners on the probed floor
+		for (int32 Index = 0; Index < NumEntities; Index++)
+		{
+			const EAriaCrowdMode Mode = Modes[Index].Mode;
+			if (Probes[Index].bHasFloor && (Mode == EAriaCrowdMode::Running || Mode == EAriaCrowdMode::Sliding || Mode == EAriaCrowdMode::IceSliding))
+			{
+				Locations[Index].Location.Z += Params.CapsuleHalfHeight - Probes[Index].FloorDistance;
+			}
+		}
+	});
+}
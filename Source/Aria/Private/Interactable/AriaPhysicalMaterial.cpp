@@ -0,0 +1,36 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Interactable/AriaPhysicalMaterial.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+
+EAriaSurfaceKind UAriaPhysicalMaterial::GetSurfaceKinds(const FHitResult& HitResult, bool& bOutHasSurfaceMaterial)
+{
+	// queries that don't return the physical material still know the simple material of the hit body
+	const UPhysicalMaterial* PhysicalMaterial = HitResult.PhysMaterial.Get();
+	if (!PhysicalMaterial && HitResult.Component.IsValid())
+	{
+		if (const FBodyInstance* BodyInstance = HitResult.Component->GetBodyInstance())
+		{
+			PhysicalMaterial = BodyInstance->GetSimplePhysicalMaterial();
+		}
+	}
+
+	const UAriaPhysicalMaterial* SurfaceMaterial = Cast<UAriaPhysicalMaterial>(PhysicalMaterial);
+	bOutHasSurfaceMaterial = SurfaceMaterial != nullptr;
+
+	return SurfaceMaterial ? SurfaceMaterial->GetSurfaceKinds() : EAriaSurfaceKind::None;
+}
+
+EAriaSurfaceKind UAriaPhysicalMaterial::GetTaggedSurfaceKinds(const AActor* Actor, const FName RopeTag, const FName LadderTag, const FName IceTag, const FName MovableTag)
+{
+	if (!Actor)
+	{
+		return EAriaSurfaceKind::None;
+	}
+
+	return (Actor->ActorHasTag(RopeTag) ? EAriaSurfaceKind::Rope : EAriaSurfaceKind::None)
+		| (Actor->ActorHasTag(LadderTag) ? EAriaSurfaceKind::Ladder : EAriaSurfaceKind::None)
+		| (Actor->ActorHasTag(IceTag) ? EAriaSurfaceKind::Ice : EAriaSurfaceKind::None)
+		| (Actor->ActorHasTag(MovableTag) ? EAriaSurfaceKind::Movable : EAriaSurfaceKind::None);
+}
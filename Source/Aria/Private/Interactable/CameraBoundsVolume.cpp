@@ -0,0 +1,62 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Interactable/CameraBoundsVolume.h"
+#include "Components/BrushComponent.h"
+#include "Manager/CameraBoundsSubsystem.h"
+
+void FCameraFraming::Blend(const FCameraFraming& Other, const float Alpha)
+{
+	// a disabled dead zone follows the hero directly, the same as zero offsets
+	const auto GetOffsets = [](const FDeadFollowZone& Zone)
+	{
+		return Zone.bEnabled ? FVector(Zone.LeftOffset, Zone.RightOffset, Zone.TopOffset) : FVector::ZeroVector;
+	};
+
+	const FVector Offsets = FMath::Lerp(GetOffsets(DeadFollowZone), GetOffsets(Other.DeadFollowZone), Alpha);
+	DeadFollowZone.bEnabled = DeadFollowZone.bEnabled || Other.DeadFollowZone.bEnabled;
+	DeadFollowZone.LeftOffset = Offsets.X;
+	DeadFollowZone.RightOffset = Offsets.Y;
+	DeadFollowZone.TopOffset = Offsets.Z;
+	FollowLagSpeed = FMath::Lerp(FollowLagSpeed, Other.FollowLagSpeed, Alpha);
+}
+
+ACameraBoundsVolume::ACameraBoundsVolume()
+{
+	// found through the camera bounds grid, not through overlaps
+	GetBrushComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GetBrushComponent()->SetGenerateOverlapEvents(false);
+}
+
+FBox2D ACameraBoundsVolume::GetPlaneBounds() const
+{
+	const FBox Bounds = GetBrushComponent()->Bounds.GetBox();
+	return FBox2D(FVector2D(Bounds.Min.X, Bounds.Min.Z), FVector2D(Bounds.Max.X, Bounds.Max.Z));
+}
+
+FBox2D ACameraBoundsVolume::GetClampBounds() const
+{
+	const FBox2D Bounds = GetPlaneBounds();
+	const FVector2D Center = Bounds.GetCenter();
+	const FVector2D Extent = (Bounds.GetExtent() - ClampPadding).ComponentMax(FVector2D::ZeroVector);
+	return FBox2D(Center - Extent, Center + Extent);
+}
+
+void ACameraBoundsVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (const auto Subsystem = GetWorld()->GetSubsystem<UCameraBoundsSubsystem>())
+	{
+		Subsystem->Register(this);
+	}
+}
+
+void ACameraBoundsVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (const auto Subsystem = GetWorld()->GetSubsystem<UCameraBoundsSubsystem>())
+	{
+		Subsystem->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,45 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Interactable/TraversalVolume.h"
+#include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Components/BrushComponent.h"
+
+ATraversalVolume::ATraversalVolume()
+{
+	GetBrushComponent()->SetCollisionProfileName("Trigger");
+	GetBrushComponent()->SetGenerateOverlapEvents(true);
+}
+
+void ATraversalVolume::NotifyActorBeginOverlap(AActor* OtherActor)
+{
+	Super::NotifyActorBeginOverlap(OtherActor);
+
+	if (const auto AriaCharacter = Cast<AAriaCharacter>(OtherActor))
+	{
+		AriaCharacter->GetAriaCharacterMovement()->EnterTraversalVolume(this);
+	}
+}
+
+void ATraversalVolume::NotifyActorEndOverlap(AActor* OtherActor)
+{
+	Super::NotifyActorEndOverlap(OtherActor);
+
+	if (const auto AriaCharacter = Cast<AAriaCharacter>(OtherActor))
+	{
+		AriaCharacter->GetAriaCharacterMovement()->ExitTraversalVolume(this);
+	}
+}
+
+void ATraversalVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// release the characters that are still inside
+	TArray<AActor*> OverlappingActors;
+	GetOverlappingActors(OverlappingActors, AAriaCharacter::StaticClass());
+	for (AActor* OverlappingActor : OverlappingActors)
+	{
+		NotifyActorEndOverlap(OverlappingActor);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,134 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Manager/AriaCrowdSubsystem.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutor.h"
+#include "MassProcessingTypes.h"
+#include "Character/AriaCharacter.h"
+#include "Crowd/AriaCrowdFragments.h"
+#include "Crowd/AriaCrowdTraversalProcessor.h"
+
+void UAriaCrowdSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	// MassGameplay isn't enabled, so the processor runs outside the processing phases
+	TraversalProcessor = NewObject<UAriaCrowdTraversalProcessor>(this);
+	TraversalProcessor->CallInitialize(this);
+
+	if (FMassEntityManager* EntityManager = GetEntityManager())
+	{
+		RunnerArchetype = EntityManager->CreateArchetype({
+			FAriaCrowdLocationFragment::StaticStruct(),
+			FAriaCrowdVelocityFragment::StaticStruct(),
+			FAriaCrowdModeFragment::StaticStruct(),
+			FAriaCrowdProbeFragment::StaticStruct()
+		}, TEXT("AriaCrowdRunner"));
+	}
+}
+
+void UAriaCrowdSubsystem::Deinitialize()
+{
+	TraversalProcessor = nullptr;
+	RunnerCount = 0;
+
+	Super::Deinitialize();
+}
+
+void UAriaCrowdSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (RunnerCount == 0 || !EntityManager || !TraversalProcessor)
+	{
+		return;
+	}
+
+	FMassProcessingContext ProcessingContext(*EntityManager, DeltaTime);
+	UE::Mass::Executor::Run(*TraversalProcessor, ProcessingContext);
+}
+
+TStatId UAriaCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAriaCrowdSubsystem, STATGROUP_Tickables);
+}
+
+bool UAriaCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FMassEntityManager* UAriaCrowdSubsystem::GetEntityManager() const
+{
+	const UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	return EntitySubsystem ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+}
+
+void UAriaCrowdSubsystem::SpawnRunners(const TSubclassOf<AAriaCharacter> CharacterClass, TConstArrayView<FVector> Locations, const float Direction, TArray<FMassEntityHandle>& OutRunners)
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager || !RunnerArchetype.IsValid() || Locations.IsEmpty())
+	{
+		return;
+	}
+
+	// one shared fragment per character class, runners of the same class end up in the same chunks
+	FMassArchetypeSharedFragmentValues SharedValues;
+	SharedValues.AddConstSharedFragment(EntityManager->GetOrCreateConstSharedFragment(FAriaCrowdTraversalParams::MakeFromCharacter(CharacterClass)));
+	SharedValues.Sort();
+
+	const int32 FirstRunner = OutRunners.Num();
+	EntityManager->BatchCreateEntities(RunnerArchetype, SharedValues, Locations.Num(), OutRunners);
+
+	for (int32 Index = 0; Index < Locations.Num(); Index++)
+	{
+		const FMassEntityHandle Runner = OutRunners[FirstRunner + Index];
+		EntityManager->GetFragmentDataChecked<FAriaCrowdLocationFragment>(Runner).Location = Locations[Index];
+		EntityManager->GetFragmentDataChecked<FAriaCrowdModeFragment>(Runner).Direction = Direction < 0.f ? -1.f : 1.f;
+	}
+
+	RunnerCount += Locations.Num();
+}
+
+void UAriaCrowdSubsystem::DestroyRunners(TConstArrayView<FMassEntityHandle> Runners)
+{
+	if (FMassEntityManager* EntityManager = GetEntityManager())
+	{
+		EntityManager->BatchDestroyEntities(Runners);
+		RunnerCount = FMath::Max(0, RunnerCount - Runners.Num());
+	}
+}
+
+void UAriaCrowdSubsystem::SetWantsToSlide(TConstArrayView<FMassEntityHandle> Runners, const bool bWantsToSlide)
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager)
+	{
+		return;
+	}
+
+	for (const FMassEntityHandle Runner : Runners)
+	{
+		if (EntityManager->IsEntityValid(Runner))
+		{
+			EntityManager->GetFragmentDataChecked<FAriaCrowdModeFragment>(Runner).bWantsToSlide = bWantsToSlide;
+		}
+	}
+}
+
+void UAriaCrowdSubsystem::GetRunnerLocations(TConstArrayView<FMassEntityHandle> Runners, TArray<FVector>& OutLocations) const
+{
+	OutLocations.Reset(Runners.Num());
+	const FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager)
+	{
+		return;
+	}
+
+	for (const FMassEntityHandle Runner : Runners)
+	{
+		OutLocations.Add(EntityManager->IsEntityValid(Runner) ? EntityManager->GetFragmentDataChecked<FAriaCrowdLocationFragment>(Runner).Location : FVector::ZeroVector);
+	}
+}
@@ -0,0 +1,338 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Manager/AriaMovementSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Utils/AriaStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tick Batch"), STAT_AriaTickBatch, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Probe Batch"), STAT_AriaProbeBatch, STATGROUP_AriaMovement);
+DECLARE_CYCLE_STAT(TEXT("Update Movement LODs"), STAT_AriaUpdateMovementLods, STATGROUP_AriaMovement);
+
+static TAutoConsoleVariable<bool> CVarAriaBatchedMovementTick(
+	TEXT("aria.Movement.BatchedTick"),
+	true,
+	TEXT("Tick Aria movement components in one batch, the transition probes of the batch are traced in parallel before the moves."));
+
+static TAutoConsoleVariable<int32> CVarAriaWorldSceneQueryBudget(
+	TEXT("aria.Movement.WorldSceneQueryBudget"),
+	0,
+	TEXT("Scene queries all Aria movement components of a world may issue per frame, shared evenly between them before low priority transitions are deferred. 0 for no limit."));
+
+void FAriaMovementBatchTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Subsystem)
+	{
+		Subsystem->TickBatch(DeltaTime, TickType);
+	}
+}
+
+FString FAriaMovementBatchTickFunction::DiagnosticMessage()
+{
+	return TEXT("FAriaMovementBatchTickFunction");
+}
+
+void UAriaMovementSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// same group as the character movement it replaces
+	BatchTickFunction.Subsystem = this;
+	BatchTickFunction.bCanEverTick = true;
+	BatchTickFunction.TickGroup = TG_PrePhysics;
+	BatchTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+	bBatchedTickEnabled = IsBatchedTickEnabled();
+}
+
+void UAriaMovementSubsystem::Deinitialize()
+{
+	if (BatchTickFunction.IsTickFunctionRegistered())
+	{
+		BatchTickFunction.UnRegisterTickFunction();
+	}
+
+	Super::Deinitialize();
+}
+
+void UAriaMovementSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// the world budget covers the movement of one frame
+	const int32 WorldSceneQueries = WorldSceneQueryCount.exchange(0, std::memory_order_relaxed);
+	if (const int32 Budget = CVarAriaWorldSceneQueryBudget.GetValueOnGameThread(); Budget > 0 && WorldSceneQueries > Budget)
+	{
+		UE_LOG(LogAriaCharacterMovement, Warning, TEXT("Aria movement issued %d scene queries this frame, the world budget is %d"), WorldSceneQueries, Budget);
+	}
+
+	ApplyBatchedTick();
+
+	LodUpdateTime -= DeltaTime;
+	if (LodUpdateTime <= 0.f)
+	{
+		LodUpdateTime = LodUpdateInterval;
+		UpdateMovementLods();
+	}
+}
+
+TStatId UAriaMovementSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAriaMovementSubsystem, STATGROUP_Tickables);
+}
+
+bool UAriaMovementSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UAriaMovementSubsystem::GetWorldSceneQueryShare() const
+{
+	// an even share per character, so the characters that tick last are not the only ones deferring
+	const int32 Budget = CVarAriaWorldSceneQueryBudget.GetValueOnAnyThread();
+	return Budget > 0 ? FMath::Max(Budget / FMath::Max(Movements.Num(), 1), 1) : 0;
+}
+
+bool UAriaMovementSubsystem::IsBatchedTickEnabled() const
+{
+	return CVarAriaBatchedMovementTick.GetValueOnGameThread();
+}
+
+void UAriaMovementSubsystem::RegisterMovement(UAriaCharacterMovement* Movement)
+{
+	if (Movements.Contains(Movement))
+	{
+		return;
+	}
+
+	Movements.Add(Movement);
+	PendingTickTimes.Add(0.f);
+	MovementBases.AddDefaulted();
+	SetMovementBatched(Movements.Num() - 1, bBatchedTickEnabled);
+}
+
+void UAriaMovementSubsystem::UnregisterMovement(UAriaCharacterMovement* Movement)
+{
+	const int32 Index = Movements.Find(Movement);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	SetMovementBatched(Index, false);
+	Movements.RemoveAtSwap(Index);
+	PendingTickTimes.RemoveAtSwap(Index);
+	MovementBases.RemoveAtSwap(Index);
+}
+
+void UAriaMovementSubsystem::ApplyBatchedTick()
+{
+	// the console variable applies to the components already registered too
+	const bool bEnabled = IsBatchedTickEnabled();
+	if (bEnabled == bBatchedTickEnabled)
+	{
+		return;
+	}
+
+	bBatchedTickEnabled = bEnabled;
+	for (int32 Index = 0; Index < Movements.Num(); Index++)
+	{
+		SetMovementBatched(Index, bEnabled);
+	}
+}
+
+void UAriaMovementSubsystem::SetMovementBatched(const int32 Index, const bool bBatched)
+{
+	UAriaCharacterMovement* Movement = Movements[Index];
+	if (Movement->IsTickBatched() == bBatched)
+	{
+		return;
+	}
+
+	Movement->SetTickBatched(bBatched);
+
+	// run after the character and, through it, after the controller that feeds its input, the mesh runs after the move like it does after the movement tick
+	ACharacter* Character = Movement->GetCharacterOwner();
+	if (Character && bBatched)
+	{
+		BatchTickFunction.AddPrerequisite(Character, Character->PrimaryActorTick);
+		if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+		{
+			AddBatchTickDependent(Mesh->PrimaryComponentTick);
+		}
+	}
+	else if (Character)
+	{
+		BatchTickFunction.RemovePrerequisite(Character, Character->PrimaryActorTick);
+		if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+		{
+			RemoveBatchTickDependent(Mesh->PrimaryComponentTick);
+		}
+	}
+
+	UpdateBaseTickDependency(Index);
+}
+
+void UAriaMovementSubsystem::UpdateBaseTickDependency(const int32 Index)
+{
+	// the batch takes over the movement base prerequisites of the disabled movement tick
+	const UAriaCharacterMovement* Movement = Movements[Index];
+	UPrimitiveComponent* NewBase = Movement->IsTickBatched() ? Movement->GetMovementBase() : nullptr;
+	if (IsBatchedCharacterBase(NewBase))
+	{
+		NewBase = nullptr;
+	}
+
+	const TWeakObjectPtr<UPrimitiveComponent> OldBase = MovementBases[Index];
+	if (OldBase == NewBase)
+	{
+		return;
+	}
+
+	// several characters may stand on the same base
+	if (int32* References = BaseReferences.Find(OldBase); References && --*References == 0)
+	{
+		BaseReferences.Remove(OldBase);
+		MovementBaseUtility::RemoveTickDependency(BatchTickFunction, OldBase.Get());
+	}
+
+	if (NewBase && ++BaseReferences.FindOrAdd(NewBase) == 1)
+	{
+		MovementBaseUtility::AddTickDependency(BatchTickFunction, NewBase);
+	}
+
+	MovementBases[Index] = NewBase;
+}
+
+bool UAriaMovementSubsystem::IsBatchedCharacterBase(const UPrimitiveComponent* Base) const
+{
+	// the batch moves those itself, depending on their mesh would close a cycle through the batch
+	const ACharacter* BaseCharacter = Base ? Cast<ACharacter>(Base->GetOwner()) : nullptr;
+	const auto BaseMovement = BaseCharacter ? Cast<UAriaCharacterMovement>(BaseCharacter->GetCharacterMovement()) : nullptr;
+	return BaseMovement && BaseMovement->IsTickBatched();
+}
+
+void UAriaMovementSubsystem::AddBatchTickDependent(FTickFunction& TickFunction)
+{
+	TickFunction.AddPrerequisite(this, BatchTickFunction);
+}
+
+void UAriaMovementSubsystem::RemoveBatchTickDependent(FTickFunction& TickFunction)
+{
+	TickFunction.RemovePrerequisite(this, BatchTickFunction);
+}
+
+void UAriaMovementSubsystem::TickBatch(const float DeltaTime, const ELevelTick TickType)
+{
+	ARIA_MOVEMENT_SCOPE(TickBatch);
+
+	// gather the components due this frame, reduced LOD tiers accumulate time until their interval passed
+	DueMovements.Reset();
+	for (int32 Index = 0; Index < Movements.Num(); Index++)
+	{
+		UAriaCharacterMovement* Movement = Movements[Index];
+		if (!Movement->IsTickBatched() || Movement->GetMovementLod() == EAriaMovementLod::Dormant || !Movement->IsRegistered())
+		{
+			PendingTickTimes[Index] = 0.f;
+			continue;
+		}
+
+		PendingTickTimes[Index] += DeltaTime;
+		if (PendingTickTimes[Index] >= Movement->GetLodTickInterval())
+		{
+			DueMovements.Emplace(Movement, PendingTickTimes[Index]);
+			PendingTickTimes[Index] = 0.f;
+		}
+	}
+
+	// probe phase, read-only scene queries spread over the worker threads
+	ProbeBatch();
+
+	for (const TPair<TWeakObjectPtr<UAriaCharacterMovement>, float>& DueMovement : DueMovements)
+	{
+		// an earlier move may have destroyed the character
+		UAriaCharacterMovement* Movement = DueMovement.Key.Get();
+		if (!Movement || !Movement->IsRegistered())
+		{
+			continue;
+		}
+
+		Movement->TickComponent(DueMovement.Value, TickType, &Movement->PrimaryComponentTick);
+	}
+
+	// the moves may have landed on a new base, the next batch waits for it
+	for (int32 Index = 0; Index < Movements.Num(); Index++)
+	{
+		UpdateBaseTickDependency(Index);
+	}
+}
+
+void UAriaMovementSubsystem::ProbeBatch()
+{
+	ARIA_MOVEMENT_SCOPE(ProbeBatch);
+
+	// throttled characters only look for transitions every few ticks, probing for them would mostly waste queries
+	ProbeMovements.Reset();
+	ProbeRequests.Reset();
+	for (const TPair<TWeakObjectPtr<UAriaCharacterMovement>, float>& DueMovement : DueMovements)
+	{
+		UAriaCharacterMovement* Movement = DueMovement.Key.Get();
+		if (FAriaProbeRequest Request; Movement && Movement->GetMovementLod() != EAriaMovementLod::Throttled && Movement->MakeProbeRequest(Request))
+		{
+			ProbeMovements.Add(Movement);
+			ProbeRequests.Add(Request);
+		}
+	}
+
+	// the workers only run scene queries into their own result, the components are written once they are done
+	ProbeResults.SetNum(ProbeRequests.Num());
+	ParallelFor(ProbeRequests.Num(), [this](const int32 Index)
+	{
+		ProbeMovements[Index]->TraceProbeRequest(ProbeRequests[Index], ProbeResults[Index]);
+	});
+
+	for (int32 Index = 0; Index < ProbeMovements.Num(); Index++)
+	{
+		ProbeMovements[Index]->ApplyProbeResult(ProbeRequests[Index], ProbeResults[Index]);
+	}
+
+	ProbeMovements.Reset();
+}
+
+void UAriaMovementSubsystem::UpdateMovementLods()
+{
+	ARIA_MOVEMENT_SCOPE(UpdateMovementLods);
+
+	// every player view counts, a listen or dedicated server has several
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	for (UAriaCharacterMovement* Movement : Movements)
+	{
+		if (!Movement->UpdatedComponent || !Movement->GetCharacterOwner())
+		{
+			continue;
+		}
+
+		const FVector Location = Movement->UpdatedComponent->GetComponentLocation();
+		float ViewDistanceSquared = TNumericLimits<float>::Max();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ViewDistanceSquared = FMath::Min(ViewDistanceSquared, FVector::DistSquared(ViewLocation, Location));
+		}
+
+		const bool bIsVisible = Movement->GetCharacterOwner()->WasRecentlyRendered(LodUpdateInterval);
+		Movement->SetMovementLod(Movement->EvaluateMovementLod(FMath::Sqrt(ViewDistanceSquared), bIsVisible));
+	}
+}
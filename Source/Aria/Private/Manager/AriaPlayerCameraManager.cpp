@@ -3,37 +3,73 @@
 #include "Manager/AriaPlayerCameraManager.h"
 #include "DrawDebugHelpers.h"
 #include "Character/AriaCharacter.h"
+#include "Character/AriaCharacterMovement.h"
 #include "Utils/AriaMath.h"
+#include "Utils/AriaStats.h"
 #include "GameFramework/PlayerController.h"
 
 DEFINE_LOG_CATEGORY(LogAriaCameraManager);
 
-void AAriaPlayerCameraManager::BeginPlay()
-{
-	Super::BeginPlay();
-	AriaCharacterOwner = Cast<AAriaCharacter>(GetOwningPlayerController()->GetPawn());
-	check(AriaCharacterOwner);
-}
+DECLARE_CYCLE_STAT(TEXT("Camera Follow"), STAT_AriaCameraFollow, STATGROUP_AriaMovement);
 
 void AAriaPlayerCameraManager::UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime)
 {
 	Super::UpdateViewTarget(OutVT, DeltaTime);
-	FollowCharacter(OutVT, DeltaTime);
+
+	// the pawn may be possessed after the camera manager begins play, or the view target may change
+	if (const UAriaCharacterMovement* Movement = ResolveFollowedMovement(OutVT))
+	{
+		// nothing was simulated yet, keep the view target camera
+		if (FAriaCameraSnapshot Snapshot = Movement->GetCameraSnapshot(); Snapshot.Frame != 0)
+		{
+			// the view is set up right after this, anything that moved the pawn since its movement tick is picked up too
+			if (bLateUpdateFollow)
+			{
+				Snapshot.Location = Movement->GetCameraTargetLocation();
+			}
+
+			FollowCharacter(Snapshot, DeltaTime);
+		}
+	}
 }
 
-void AAriaPlayerCameraManager::FollowCharacter(FTViewTarget& OutVT, const float DeltaTime)
+const UAriaCharacterMovement* AAriaPlayerCameraManager::ResolveFollowedMovement(const FTViewTarget& VT)
 {
+	if (!FollowedMovement || FollowedMovement->GetOwner() != VT.Target)
+	{
+		if (FollowedMovement)
+		{
+			FollowedMovement->RemoveCameraTickDependent(PrimaryActorTick);
+		}
+
+		const auto AriaCharacter = Cast<AAriaCharacter>(VT.Target);
+		FollowedMovement = AriaCharacter ? AriaCharacter->GetAriaCharacterMovement() : nullptr;
+
+		// the camera is updated after every tick group, the camera manager tick is kept behind the movement as well
+		if (FollowedMovement)
+		{
+			FollowedMovement->AddCameraTickDependent(PrimaryActorTick);
+		}
+	}
+
+	return FollowedMovement;
+}
+
+void AAriaPlayerCameraManager::FollowCharacter(const FAriaCameraSnapshot& Snapshot, const float DeltaTime)
+{
+	ARIA_MOVEMENT_SCOPE(CameraFollow);
+
+	BlendCameraBounds(Snapshot.Location);
+	const FCameraFraming& Framing = CameraBoundsBlend.Framing;
+
 	const FVector CameraLocation = GetCameraLocation();
-	const FVector TargetLocation = AriaCharacterOwner->GetActorLocation();
 	const FVector ViewTargetLocation = ViewTarget.POV.Location;
-	const float FollowTargetX = GetFollowTargetX(TargetLocation, CameraLocation);
-	const float FollowTargetZ = GetFollowTargetZ(TargetLocation, CameraLocation, ViewTargetLocation);
-	const FVector NewCameraLocation = FVector(FollowTargetX, ViewTargetLocation.Y, FollowTargetZ);
+	const FVector NewCameraLocation = ClampToCameraBounds(GetFollowLocation(Framing, Snapshot, CameraLocation, ViewTargetLocation));
 
 	if (bEnableFollowLag)
 	{
 		const FVector CurrentCameraLocation = CameraLocation.IsNearlyZero() ? ViewTargetLocation : CameraLocation;
-		ViewTarget.POV.Location = FMath::VInterpTo(CurrentCameraLocation, NewCameraLocation, DeltaTime, FollowLagSpeed);
+		ViewTarget.POV.Location = FMath::VInterpTo(CurrentCameraLocation, NewCameraLocation, DeltaTime, Framing.FollowLagSpeed);
 	}
 	else
 	{
@@ -41,23 +77,61 @@ void AAriaPlayerCameraManager::FollowCharacter(FTViewTarget& OutVT, const float
 	}
 }
 
-float AAriaPlayerCameraManager::GetFollowTargetX(const FVector& TargetLocation, const FVector& CameraLocation) const
+FVector AAriaPlayerCameraManager::GetFollowLocation(const FCameraFraming& Framing, const FAriaCameraSnapshot& Snapshot, const FVector& CameraLocation, const FVector& ViewTargetLocation)
+{
+	const float FollowTargetX = GetFollowTargetX(Framing.DeadFollowZone, Snapshot.Location, CameraLocation);
+	const float FollowTargetZ = GetFollowTargetZ(Framing.DeadFollowZone, Snapshot, CameraLocation, ViewTargetLocation);
+	return FVector(FollowTargetX, ViewTargetLocation.Y, FollowTargetZ);
+}
+
+void AAriaPlayerCameraManager::BlendCameraBounds(const FVector& TargetLocation)
+{
+	// start from the framing of the camera manager and blend the volumes around the hero over it
+	CameraBoundsBlend.Framing.DeadFollowZone = DeadFollowZone;
+	CameraBoundsBlend.Framing.FollowLagSpeed = FollowLagSpeed;
+	CameraBoundsBlend.Clamps.Reset();
+
+	if (!CameraBoundsSubsystem)
+	{
+		CameraBoundsSubsystem = GetWorld()->GetSubsystem<UCameraBoundsSubsystem>();
+	}
+
+	if (CameraBoundsSubsystem)
+	{
+		CameraBoundsSubsystem->Evaluate(TargetLocation, CameraBoundsBlend);
+	}
+}
+
+FVector AAriaPlayerCameraManager::ClampToCameraBounds(const FVector& CameraLocation) const
+{
+	FVector ClampedLocation = CameraLocation;
+	for (const TPair<FBox2D, float>& Clamp : CameraBoundsBlend.Clamps)
+	{
+		const FBox2D& Bounds = Clamp.Key;
+		const FVector InsideLocation(FMath::Clamp(ClampedLocation.X, Bounds.Min.X, Bounds.Max.X), ClampedLocation.Y, FMath::Clamp(ClampedLocation.Z, Bounds.Min.Y, Bounds.Max.Y));
+		ClampedLocation = FMath::Lerp(ClampedLocation, InsideLocation, Clamp.Value);
+	}
+
+	return ClampedLocation;
+}
+
+float AAriaPlayerCameraManager::GetFollowTargetX(const FDeadFollowZone& DeadZone, const FVector& TargetLocation, const FVector& CameraLocation)
 {
 	// Follow the hero if Dead Zone doesn't enabled or horizontal limits are zero 
-	if (!DeadFollowZone.bEnabled || (FMath::IsNearlyZero(DeadFollowZone.LeftOffset) && FMath::IsNearlyZero(DeadFollowZone.RightOffset)))
+	if (!DeadZone.bEnabled || (FMath::IsNearlyZero(DeadZone.LeftOffset) && FMath::IsNearlyZero(DeadZone.RightOffset)))
 	{
 		return TargetLocation.X;
 	}
 
 	// Move the camera Left after the Target reached the left limit
-	const float LeftDeadZone = TargetLocation.X - DeadFollowZone.LeftOffset;
+	const float LeftDeadZone = TargetLocation.X - DeadZone.LeftOffset;
 	if (FAriaMath::IsFirstGreater(LeftDeadZone, CameraLocation.X))
 	{
 		return LeftDeadZone;
 	}
 
 	// Move the camera Right after the Target reached the right limit
-	const float RightDeadZone = TargetLocation.X + DeadFollowZone.RightOffset;
+	const float RightDeadZone = TargetLocation.X + DeadZone.RightOffset;
 	if (FAriaMath::IsFirstLess(RightDeadZone, CameraLocation.X))
 	{
 		return RightDeadZone;
@@ -67,16 +141,16 @@ float AAriaPlayerCameraManager::GetFollowTargetX(const FVector& TargetLocation,
 	return CameraLocation.X;
 }
 
-float AAriaPlayerCameraManager::GetFollowTargetZ(const FVector& TargetLocation, const FVector& CameraLocation, const FVector& ViewTargetLocation) const
+float AAriaPlayerCameraManager::GetFollowTargetZ(const FDeadFollowZone& DeadZone, const FAriaCameraSnapshot& Snapshot, const FVector& CameraLocation, const FVector& ViewTargetLocation)
 {
 	// Follow the hero if Dead Zone doesn't enabled or top limit are zero 
-	if (!DeadFollowZone.bEnabled || FMath::IsNearlyZero(DeadFollowZone.TopOffset))
+	if (!DeadZone.bEnabled || FMath::IsNearlyZero(DeadZone.TopOffset))
 	{
 		return ViewTargetLocation.Z;
 	}
 
 	// Move the camera Up after the Target has reached the top limit
-	const float TopDeadZone = TargetLocation.Z - DeadFollowZone.TopOffset;
+	const float TopDeadZone = Snapshot.Location.Z - DeadZone.TopOffset;
 	if (FAriaMath::IsFirstGreater(TopDeadZone, CameraLocation.Z, 5))
 	{
 		return TopDeadZone;
@@ -90,9 +164,7 @@ float AAriaPlayerCameraManager::GetFollowTargetZ(const FVector& TargetLocation,
 	}
 
 	// If character is grounded set camera to the bottom zone
-	FFindFloorResult FloorResult;
-	AriaCharacterOwner->GetCharacterMovement()->FindFloor(TargetLocation, FloorResult, false);
-	if (FloorResult.IsWalkableFloor())
+	if (Snapshot.bIsGrounded)
 	{
 		return BottomDeadZone;
 	}
@@ -0,0 +1,123 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Manager/CameraBoundsSubsystem.h"
+#include "Algo/BinarySearch.h"
+
+DEFINE_LOG_CATEGORY(LogCameraBounds);
+
+bool UCameraBoundsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCameraBoundsSubsystem::Register(const ACameraBoundsVolume* Volume)
+{
+	FEntry Entry;
+	Entry.Volume = Volume;
+	Entry.Bounds = Volume->GetPlaneBounds();
+	Entry.ClampBounds = Volume->GetClampBounds();
+	Entry.Framing = Volume->Framing;
+	Entry.BlendDistance = Volume->BlendDistance;
+	Entry.Priority = Volume->Priority;
+	Entry.bClampCamera = Volume->bClampCamera;
+
+	const int32 Index = Entries.Add(Entry);
+
+	// keep every cell sorted by priority so the blend is applied from the lowest to the highest
+	ForEachCell(Entries[Index], [this, Index](const FIntPoint& Cell)
+	{
+		TArray<int32, TInlineAllocator<4>>& CellEntries = Cells.FindOrAdd(Cell);
+		const int32 Priority = Entries[Index].Priority;
+		const int32 InsertAt = Algo::UpperBoundBy(CellEntries, Priority, [this](const int32 EntryIndex) { return Entries[EntryIndex].Priority; });
+		CellEntries.Insert(Index, InsertAt);
+	});
+
+	UE_LOG(LogCameraBounds, Verbose, TEXT("Registered %s, %d camera bounds volumes"), *GetNameSafe(Volume), Entries.Num());
+}
+
+void UCameraBoundsSubsystem::Unregister(const ACameraBoundsVolume* Volume)
+{
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It->Volume != Volume)
+		{
+			continue;
+		}
+
+		const int32 Index = It.GetIndex();
+		ForEachCell(*It, [this, Index](const FIntPoint& Cell)
+		{
+			if (TArray<int32, TInlineAllocator<4>>* CellEntries = Cells.Find(Cell))
+			{
+				CellEntries->Remove(Index);
+				if (CellEntries->IsEmpty())
+				{
+					Cells.Remove(Cell);
+				}
+			}
+		});
+
+		It.RemoveCurrent();
+		return;
+	}
+}
+
+void UCameraBoundsSubsystem::Evaluate(const FVector& Location, FCameraBoundsBlend& InOutBlend) const
+{
+	InOutBlend.Clamps.Reset();
+
+	const FVector2D PlaneLocation(Location.X, Location.Z);
+	const TArray<int32, TInlineAllocator<4>>* CellEntries = Cells.Find(ToCell(PlaneLocation));
+	if (!CellEntries)
+	{
+		return;
+	}
+
+	for (const int32 Index : *CellEntries)
+	{
+		const FEntry& Entry = Entries[Index];
+		const float Weight = GetWeight(Entry, PlaneLocation);
+		if (Weight <= 0.f)
+		{
+			continue;
+		}
+
+		InOutBlend.Framing.Blend(Entry.Framing, Weight);
+		if (Entry.bClampCamera)
+		{
+			InOutBlend.Clamps.Emplace(Entry.ClampBounds, Weight);
+		}
+	}
+}
+
+FIntPoint UCameraBoundsSubsystem::ToCell(const FVector2D& Location)
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+float UCameraBoundsSubsystem::GetWeight(const FEntry& Entry, const FVector2D& Location)
+{
+	// full weight inside the bounds, fading out linearly over the blend distance
+	const float Distance = FMath::Sqrt(Entry.Bounds.ComputeSquaredDistanceToPoint(Location));
+	if (Entry.BlendDistance <= 0.f)
+	{
+		return Distance > 0.f ? 0.f : 1.f;
+	}
+
+	return FMath::Clamp(1.f - Distance / Entry.BlendDistance, 0.f, 1.f);
+}
+
+void UCameraBoundsSubsystem::ForEachCell(const FEntry& Entry, const TFunctionRef<void(const FIntPoint&)> Callback) const
+{
+	// a volume is indexed in every cell its blend region touches
+	const FBox2D Region = Entry.Bounds.ExpandBy(Entry.BlendDistance);
+	const FIntPoint MinCell = ToCell(Region.Min);
+	const FIntPoint MaxCell = ToCell(Region.Max);
+	for (int32 CellZ = MinCell.Y; CellZ <= MaxCell.Y; CellZ++)
+	{
+		for (int32 CellX = MinCell.X; CellX <= MaxCell.X; CellX++)
+		{
+			Callback(FIntPoint(CellX, CellZ));
+		}
+	}
+}
@@ -0,0 +1,61 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Manager/MantleLedgeSubsystem.h"
+#include "Character/AriaCharacterMovement.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY(LogMantleLedges);
+
+void UMantleLedgeSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const FString MapPackageName = UWorld::RemovePIEPrefix(InWorld.GetOutermost()->GetName());
+	const FString Filename = GetLedgeFilename(MapPackageName);
+	if (!FPaths::FileExists(Filename))
+	{
+		UE_LOG(LogMantleLedges, Verbose, TEXT("No baked ledges for %s, mantle uses runtime probes"), *MapPackageName);
+		return;
+	}
+
+	if (Database.Load(Filename))
+	{
+		UE_LOG(LogMantleLedges, Log, TEXT("Loaded %d baked ledges for %s"), Database.Num(), *MapPackageName);
+	}
+	else
+	{
+		UE_LOG(LogMantleLedges, Warning, TEXT("Failed to load baked ledges from %s, rebake the level"), *Filename);
+	}
+}
+
+void UMantleLedgeSubsystem::Deinitialize()
+{
+	Database.Unload();
+	Super::Deinitialize();
+}
+
+bool UMantleLedgeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UMantleLedgeSubsystem::FindLedge(const FVector& FrontStart, const FVector& ForwardVector, const float CheckDistance, const float CapsuleRadius, const FAriaMantleQuery& Query, FAriaMantleLedge& OutLedge) const
+{
+	const FMantleLedgeRecord* Record = Database.FindLedge(FrontStart, ForwardVector, CheckDistance, Query.ReachHeight, Query.MaxAlignmentCos, CapsuleRadius);
+	if (!Record)
+	{
+		return false;
+	}
+
+	OutLedge.Surface = FVector(Record->Surface);
+	OutLedge.SurfaceNormal = FMantleLedgeRecord::UnpackNormal(Record->SurfaceNormal);
+	OutLedge.WallNormal = FMantleLedgeRecord::UnpackNormal(Record->WallNormal);
+	OutLedge.Target = FVector(Record->Target);
+	return true;
+}
+
+FString UMantleLedgeSubsystem::GetLedgeFilename(const FString& MapPackageName)
+{
+	return FPaths::ProjectContentDir() / TEXT("MantleLedges") / FPackageName::GetShortName(MapPackageName) + TEXT(".ledges");
+}
@@ -0,0 +1,266 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Utils/AriaMovementRecording.h"
+#include "Async/Async.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace AriaMovementRecording
+{
+	constexpr uint32 FileMagic = 0x524D5241; // "ARMR"
+	constexpr uint32 FileVersion = 2;
+
+	// precedes every frame, a field is only written when it changed since the previous frame
+	enum EChangeMask : uint8
+	{
+		DeltaTimeChanged = 1 << 0,
+		InputChanged = 1 << 1,
+		IntentsChanged = 1 << 2,
+		ModeChanged = 1 << 3,
+		LocationChanged = 1 << 4,
+		VelocityChanged = 1 << 5,
+	};
+}
+
+FArchive& operator<<(FArchive& Ar, FAriaMovementRecordHeader& Header)
+{
+	Ar << Header.MapName;
+	Ar << Header.CharacterClass;
+	Ar << Header.Location;
+	Ar << Header.Rotation;
+	Ar << Header.Velocity;
+	Ar << Header.MovementMode;
+	Ar << Header.CustomMovementMode;
+	Ar << Header.SlidingTime;
+	Ar << Header.bIsDashInProgress;
+	Ar << Header.DashCooldownRemaining;
+	Ar << Header.CapsuleRadius;
+	Ar << Header.CapsuleHalfHeight;
+	return Ar;
+}
+
+#pragma region "Writer"
+FAriaMovementRecordWriter::~FAriaMovementRecordWriter()
+{
+	Close();
+}
+
+bool FAriaMovementRecordWriter::Open(const FString& Filename, const FAriaMovementRecordHeader& Header)
+{
+	using namespace AriaMovementRecording;
+
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+	FileHandle.Reset(PlatformFile.OpenWrite(*Filename));
+	if (!FileHandle)
+	{
+		return false;
+	}
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	FAriaMovementRecordHeader HeaderCopy = Header;
+	FMemoryWriter Writer(Buffer);
+	Writer << Magic << Version << HeaderCopy;
+
+	// the first frame is encoded against the start state
+	LastFrame = FAriaMovementRecordFrame();
+	LastFrame.MovementMode = Header.MovementMode;
+	LastFrame.CustomMovementMode = Header.CustomMovementMode;
+	LastFrame.Location = Header.Location;
+	LastFrame.Velocity = Header.Velocity;
+	FrameCount = 0;
+	return true;
+}
+
+void FAriaMovementRecordWriter::AddFrame(const FAriaMovementRecordFrame& Frame)
+{
+	using namespace AriaMovementRecording;
+
+	if (!FileHandle)
+	{
+		return;
+	}
+
+	// positions are stored as float offsets from the previous decoded position, so the error doesn't add up
+	FVector3f LocationDelta(Frame.Location - LastFrame.Location);
+	FVector3f Velocity(Frame.Velocity);
+	FVector3f InputVector = Frame.InputVector;
+	float DeltaTime = Frame.DeltaTime;
+	uint8 Intents = Frame.Intents;
+	uint8 MovementMode = Frame.MovementMode;
+	uint8 CustomMovementMode = Frame.CustomMovementMode;
+
+	uint8 Mask = 0;
+	Mask |= DeltaTime != LastFrame.DeltaTime ? DeltaTimeChanged : 0;
+	Mask |= InputVector != LastFrame.InputVector ? InputChanged : 0;
+	Mask |= Intents != LastFrame.Intents ? IntentsChanged : 0;
+	Mask |= MovementMode != LastFrame.MovementMode || CustomMovementMode != LastFrame.CustomMovementMode ? ModeChanged : 0;
+	Mask |= !LocationDelta.IsZero() ? LocationChanged : 0;
+	Mask |= Velocity != FVector3f(LastFrame.Velocity) ? VelocityChanged : 0;
+
+	FMemoryWriter Writer(Buffer, false, true);
+	Writer << Mask;
+	if (Mask & DeltaTimeChanged)
+	{
+		Writer << DeltaTime;
+	}
+
+	if (Mask & InputChanged)
+	{
+		Writer << InputVector;
+	}
+
+	if (Mask & IntentsChanged)
+	{
+		Writer << Intents;
+	}
+
+	if (Mask & ModeChanged)
+	{
+		Writer << MovementMode << CustomMovementMode;
+	}
+
+	if (Mask & LocationChanged)
+	{
+		Writer << LocationDelta;
+	}
+
+	if (Mask & VelocityChanged)
+	{
+		Writer << Velocity;
+	}
+
+	// keep the decoded values, the next frame is encoded against what the reader will see
+	const FVector DecodedLocation = LastFrame.Location + FVector(LocationDelta);
+	LastFrame = Frame;
+	LastFrame.Location = DecodedLocation;
+	LastFrame.Velocity = FVector(Velocity);
+	FrameCount++;
+
+	if (Buffer.Num() >= FlushSize)
+	{
+		Flush();
+	}
+}
+
+void FAriaMovementRecordWriter::Close()
+{
+	if (!FileHandle)
+	{
+		return;
+	}
+
+	Flush();
+	if (PendingFlush.IsValid())
+	{
+		PendingFlush.Wait();
+	}
+
+	FileHandle.Reset();
+}
+
+void FAriaMovementRecordWriter::Flush()
+{
+	if (Buffer.IsEmpty())
+	{
+		return;
+	}
+
+	// blocks are written in order, the game thread only waits when the disk falls a whole block behind
+	if (PendingFlush.IsValid())
+	{
+		PendingFlush.Wait();
+	}
+
+	PendingFlush = Async(EAsyncExecution::ThreadPool, [File = FileHandle.Get(), Data = MoveTemp(Buffer)]
+	{
+		File->Write(Data.GetData(), Data.Num());
+	});
+
+	Buffer.Reset(FlushSize);
+}
+#pragma endregion
+
+#pragma region "Reader"
+bool FAriaMovementRecordReader::Load(const FString& Filename, FAriaMovementRecordHeader& OutHeader, TArray<FAriaMovementRecordFrame>& OutFrames)
+{
+	using namespace AriaMovementRecording;
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Magic != FileMagic || Version != FileVersion)
+	{
+		return false;
+	}
+
+	Reader << OutHeader;
+
+	FAriaMovementRecordFrame Frame;
+	Frame.MovementMode = OutHeader.MovementMode;
+	Frame.CustomMovementMode = OutHeader.CustomMovementMode;
+	Frame.Location = OutHeader.Location;
+	Frame.Velocity = OutHeader.Velocity;
+
+	OutFrames.Reset();
+	while (!Reader.AtEnd() && !Reader.IsError())
+	{
+		uint8 Mask = 0;
+		Reader << Mask;
+		if (Mask & DeltaTimeChanged)
+		{
+			Reader << Frame.DeltaTime;
+		}
+
+		if (Mask & InputChanged)
+		{
+			Reader << Frame.InputVector;
+		}
+
+		if (Mask & IntentsChanged)
+		{
+			Reader << Frame.Intents;
+		}
+
+		if (Mask & ModeChanged)
+		{
+			Reader << Frame.MovementMode << Frame.CustomMovementMode;
+		}
+
+		if (Mask & LocationChanged)
+		{
+			FVector3f LocationDelta;
+			Reader << LocationDelta;
+			Frame.Location += FVector(LocationDelta);
+		}
+
+		if (Mask & VelocityChanged)
+		{
+			FVector3f Velocity;
+			Reader << Velocity;
+			Frame.Velocity = FVector(Velocity);
+		}
+
+		// a block cut short by a crash ends the recording
+		if (!Reader.IsError())
+		{
+			OutFrames.Add(Frame);
+		}
+	}
+
+	return !Reader.IsError() || !OutFrames.IsEmpty();
+}
+#pragma endregion
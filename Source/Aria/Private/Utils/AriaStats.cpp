@@ -0,0 +1,6 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Utils/AriaStats.h"
+
+CSV_DEFINE_CATEGORY_MODULE(ARIA_API, AriaMovement, true);
+UE_TRACE_CHANNEL_DEFINE(AriaMovementChannel);
@@ -0,0 +1,215 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#include "Utils/MantleLedgeDatabase.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+void FMantleLedgeRecord::PackNormal(const FVector& Normal, int8 (&OutPacked)[3])
+{
+	OutPacked[0] = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Normal.X, -1., 1.) * 127.));
+	OutPacked[1] = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Normal.Y, -1., 1.) * 127.));
+	OutPacked[2] = static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Normal.Z, -1., 1.) * 127.));
+}
+
+FVector FMantleLedgeRecord::UnpackNormal(const int8 (&Packed)[3])
+{
+	return FVector(Packed[0], Packed[1], Packed[2]).GetSafeNormal();
+}
+
+FMantleLedgeDatabase::FMantleLedgeDatabase() = default;
+
+FMantleLedgeDatabase::~FMantleLedgeDatabase()
+{
+	Unload();
+}
+
+bool FMantleLedgeDatabase::Load(const FString& Filename)
+{
+	Unload();
+
+	// map the file when the platform supports it, otherwise read it into memory
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedFile.Reset(PlatformFile.OpenMapped(*Filename));
+	if (MappedFile)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+		if (MappedRegion && Bind(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize()))
+		{
+			return true;
+		}
+	}
+	else if (FFileHelper::LoadFileToArray(FileData, *Filename, FILEREAD_Silent) && Bind(FileData.GetData(), FileData.Num()))
+	{
+		return true;
+	}
+
+	Unload();
+	return false;
+}
+
+void FMantleLedgeDatabase::Unload()
+{
+	Header = nullptr;
+	CellStarts = nullptr;
+	Records = nullptr;
+
+	// the region has to be released before its file
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	FileData.Empty();
+}
+
+int32 FMantleLedgeDatabase::Num() const
+{
+	return Header ? Header->NumLedges : 0;
+}
+
+bool FMantleLedgeDatabase::Bind(const uint8* Data, const int64 Size)
+{
+	if (!Data || Size < static_cast<int64>(sizeof(FHeader)))
+	{
+		return false;
+	}
+
+	const FHeader* FileHeader = reinterpret_cast<const FHeader*>(Data);
+	if (FileHeader->Magic != FileMagic || FileHeader->Version != FileVersion || FileHeader->CellSize <= 0.f)
+	{
+		return false;
+	}
+
+	const int64 NumCells = static_cast<int64>(FileHeader->GridWidth) * FileHeader->GridHeight;
+	const int64 ExpectedSize = sizeof(FHeader) + (NumCells + 1) * sizeof(uint32) + static_cast<int64>(FileHeader->NumLedges) * sizeof(FMantleLedgeRecord);
+	if (NumCells <= 0 || FileHeader->NumLedges < 0 || Size < ExpectedSize)
+	{
+		return false;
+	}
+
+	Header = FileHeader;
+	CellStarts = reinterpret_cast<const uint32*>(Data + sizeof(FHeader));
+	Records = reinterpret_cast<const FMantleLedgeRecord*>(CellStarts + NumCells + 1);
+	return true;
+}
+
+const FMantleLedgeRecord* FMantleLedgeDatabase::FindLedge(const FVector& FrontStart, const FVector& ForwardVector, const float CheckDistance, const float ReachHeight, const float MaxAlignmentCos, const float LateralTolerance) const
+{
+	if (!Header)
+	{
+		return nullptr;
+	}
+
+	// a reachable ledge is at most CheckDistance ahead and ReachHeight above the front trace
+	const auto ToCell = [this](const double Value, const float Origin, const int32 Count)
+	{
+		return FMath::Clamp(FMath::FloorToInt32((Value - Origin) / Header->CellSize), 0, Count - 1);
+	};
+
+	const int32 MinCellX = ToCell(FrontStart.X - CheckDistance - 1.f, Header->OriginX, Header->GridWidth);
+	const int32 MaxCellX = ToCell(FrontStart.X + CheckDistance + 1.f, Header->OriginX, Header->GridWidth);
+	const int32 MinCellZ = ToCell(FrontStart.Z, Header->OriginZ, Header->GridHeight);
+	const int32 MaxCellZ = ToCell(FrontStart.Z + ReachHeight, Header->OriginZ, Header->GridHeight);
+	const FVector LateralVector = FVector::CrossProduct(ForwardVector, FVector::UpVector);
+
+	const FMantleLedgeRecord* BestLedge = nullptr;
+	float BestDistance = TNumericLimits<float>::Max();
+	for (int32 CellZ = MinCellZ; CellZ <= MaxCellZ; CellZ++)
+	{
+		for (int32 CellX = MinCellX; CellX <= MaxCellX; CellX++)
+		{
+			const int32 Cell = CellZ * Header->GridWidth + CellX;
+			for (uint32 Index = CellStarts[Cell]; Index < CellStarts[Cell + 1]; Index++)
+			{
+				const FMantleLedgeRecord& Ledge = Records[Index];
+				if (FrontStart.Z < Ledge.MinReachZ || FrontStart.Z > Ledge.MaxReachZ)
+				{
+					continue;
+				}
+
+				if ((ForwardVector | -FMantleLedgeRecord::UnpackNormal(Ledge.WallNormal)) < MaxAlignmentCos)
+				{
+					continue;
+				}
+
+				// the surface is found one unit behind the wall face
+				const FVector ToSurface = FVector(Ledge.Surface) - FrontStart;
+				const float Distance = ToSurface | ForwardVector;
+				if (Distance < 0.f || Distance > CheckDistance + 1.f || FMath::Abs(ToSurface | LateralVector) > LateralTolerance)
+				{
+					continue;
+				}
+
+				if (Distance < BestDistance)
+				{
+					BestDistance = Distance;
+					BestLedge = &Ledge;
+				}
+			}
+		}
+	}
+
+	return BestLedge;
+}
+
+bool FMantleLedgeDatabase::Save(const FString& Filename, const TArray<FMantleLedgeRecord>& Records, const float CellSize)
+{
+	FHeader FileHeader;
+	FileHeader.Magic = FileMagic;
+	FileHeader.Version = FileVersion;
+	FileHeader.CellSize = CellSize;
+	FileHeader.OriginX = 0.f;
+	FileHeader.OriginZ = 0.f;
+	FileHeader.GridWidth = 1;
+	FileHeader.GridHeight = 1;
+	FileHeader.NumLedges = Records.Num();
+
+	// fit the grid around the ledges on the play plane
+	if (Records.Num() > 0)
+	{
+		FVector2f Min(TNumericLimits<float>::Max()), Max(TNumericLimits<float>::Lowest());
+		for (const FMantleLedgeRecord& Record : Records)
+		{
+			Min = FVector2f::Min(Min, FVector2f(Record.Surface.X, Record.Surface.Z));
+			Max = FVector2f::Max(Max, FVector2f(Record.Surface.X, Record.Surface.Z));
+		}
+
+		FileHeader.OriginX = FMath::FloorToFloat(Min.X / CellSize) * CellSize;
+		FileHeader.OriginZ = FMath::FloorToFloat(Min.Y / CellSize) * CellSize;
+		FileHeader.GridWidth = FMath::FloorToInt32((Max.X - FileHeader.OriginX) / CellSize) + 1;
+		FileHeader.GridHeight = FMath::FloorToInt32((Max.Y - FileHeader.OriginZ) / CellSize) + 1;
+	}
+
+	// bucket the ledges by cell
+	const int32 NumCells = FileHeader.GridWidth * FileHeader.GridHeight;
+	TArray<int32> RecordCells;
+	RecordCells.Reserve(Records.Num());
+	TArray<uint32> CellStarts;
+	CellStarts.SetNumZeroed(NumCells + 1);
+	for (const FMantleLedgeRecord& Record : Records)
+	{
+		const int32 CellX = FMath::FloorToInt32((Record.Surface.X - FileHeader.OriginX) / CellSize);
+		const int32 CellZ = FMath::FloorToInt32((Record.Surface.Z - FileHeader.OriginZ) / CellSize);
+		const int32 Cell = CellZ * FileHeader.GridWidth + CellX;
+		RecordCells.Add(Cell);
+		CellStarts[Cell + 1]++;
+	}
+
+	for (int32 Cell = 0; Cell < NumCells; Cell++)
+	{
+		CellStarts[Cell + 1] += CellStarts[Cell];
+	}
+
+	TArray<FMantleLedgeRecord> SortedRecords;
+	SortedRecords.SetNumUninitialized(Records.Num());
+	TArray<uint32> CellCursors(CellStarts.GetData(), NumCells);
+	for (int32 Index = 0; Index < Records.Num(); Index++)
+	{
+		SortedRecords[CellCursors[RecordCells[Index]]++] = Records[Index];
+	}
+
+	TArray<uint8> FileData;
+	FileData.Append(reinterpret_cast<const uint8*>(&FileHeader), sizeof(FHeader));
+	FileData.Append(reinterpret_cast<const uint8*>(CellStarts.GetData()), CellStarts.Num() * sizeof(uint32));
+	FileData.Append(reinterpret_cast<const uint8*>(SortedRecords.GetData()), SortedRecords.Num() * sizeof(FMantleLedgeRecord));
+
+	return FFileHelper::SaveArrayToFile(FileData, *Filename);
+}
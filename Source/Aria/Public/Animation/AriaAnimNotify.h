@@ -0,0 +1,33 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "AriaAnimNotify.generated.h"
+
+UENUM()
+enum class EAriaAnimEvent : uint8
+{
+	HardLandingFinished,
+	FallingToRollFinished,
+	CrawlingFinished,
+	MantleFinished,
+	DashFinished,
+};
+
+/**
+ *	Notify objects are shared by every character playing the animation, so the event is routed
+ *	through the mesh that played it to the movement component of its owner only
+ */
+UCLASS(Abstract)
+class ARIA_API UAriaAnimNotify : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+
+protected:
+	EAriaAnimEvent Event = EAriaAnimEvent::HardLandingFinished;
+};
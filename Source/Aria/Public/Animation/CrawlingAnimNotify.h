@@ -3,17 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Animation/AnimNotifies/AnimNotify.h"
+#include "Animation/AriaAnimNotify.h"
 #include "CrawlingAnimNotify.generated.h"
 
-DECLARE_MULTICAST_DELEGATE(FOnNotifiedSignature);
-
 UCLASS()
-class ARIA_API UCrawlingAnimNotify : public UAnimNotify
+class ARIA_API UCrawlingAnimNotify : public UAriaAnimNotify
 {
 	GENERATED_BODY()
 
 public:
-	FOnNotifiedSignature OnNotified;
-	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	UCrawlingAnimNotify();
 };
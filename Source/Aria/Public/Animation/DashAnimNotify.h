@@ -3,17 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Animation/AnimNotifies/AnimNotify.h"
+#include "Animation/AriaAnimNotify.h"
 #include "DashAnimNotify.generated.h"
 
-DECLARE_MULTICAST_DELEGATE(FOnNotifiedSignature)
-
 UCLASS()
-class ARIA_API UDashAnimNotify : public UAnimNotify
+class ARIA_API UDashAnimNotify : public UAriaAnimNotify
 {
 	GENERATED_BODY()
 
 public:
-	FOnNotifiedSignature OnNotified;
-	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	UDashAnimNotify();
 };
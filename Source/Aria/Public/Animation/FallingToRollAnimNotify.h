@@ -3,17 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Animation/AnimNotifies/AnimNotify.h"
+#include "Animation/AriaAnimNotify.h"
 #include "FallingToRollAnimNotify.generated.h"
 
-DECLARE_MULTICAST_DELEGATE(FOnNotifiedSignature);
-
 UCLASS()
-class ARIA_API UFallingToRollAnimNotify : public UAnimNotify
+class ARIA_API UFallingToRollAnimNotify : public UAriaAnimNotify
 {
 	GENERATED_BODY()
 
 public:
-	FOnNotifiedSignature OnNotified;
-	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	UFallingToRollAnimNotify();
 };
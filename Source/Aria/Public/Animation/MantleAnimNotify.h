@@ -3,17 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Animation/AnimNotifies/AnimNotify.h"
+#include "Animation/AriaAnimNotify.h"
 #include "MantleAnimNotify.generated.h"
 
-DECLARE_MULTICAST_DELEGATE(FOnNotifiedSigature);
-
 UCLASS()
-class ARIA_API UMantleAnimNotify : public UAnimNotify
+class ARIA_API UMantleAnimNotify : public UAriaAnimNotify
 {
 	GENERATED_BODY()
 
 public:
-	FOnNotifiedSigature OnNotified;
-	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+	UMantleAnimNotify();
 };
@@ -15,6 +15,7 @@ class USpringArmComponent;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
+struct FAnimUpdateRateParameters;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogAriaCharacter, Log, All);
 
@@ -37,7 +38,14 @@ class AAriaCharacter : public ACharacter
 public:
 	explicit AAriaCharacter(const FObjectInitializer& ObjectInitializer);
 	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
-	FCollisionQueryParams GetQueryParams() const;
+	const FCollisionQueryParams& GetQueryParams(FName TraceTag, const TStatId& StatId);
+	void RefreshQueryParams();
+	UAriaCharacterMovement* GetAriaCharacterMovement() const { return AriaCharacterMovement; }
+	void SetVisualOffset(const FVector& WorldOffset);
+
+	// Recording
+	UFUNCTION(Exec) void RecordMovement(const FString& Filename);
+	UFUNCTION(Exec) void StopRecordingMovement();
 
 protected:
 	void Move(const FInputActionValue& Value);
@@ -47,8 +55,21 @@ protected:
 	void StopSliding();
 	void CrawlingPressed();
 	void DashPressed();
+	virtual void PostInitializeComponents() override;
 	virtual void BeginPlay() override;
 
 private:
 	UPROPERTY(Transient) TObjectPtr<UAriaCharacterMovement> AriaCharacterMovement;
+
+	// Visual Offset
+	FVector CameraBoomBaseLocation = FVector::ZeroVector;
+
+	// Animation LOD
+	void OnAnimUpdateRateParamsCreated(FAnimUpdateRateParameters* Params);
+
+	// Collision Queries
+	FCollisionQueryParams QueryParams;
+	bool bQueryParamsDirty = true;
+	void AddIgnoredAttachedActors(const AActor* Actor);
+	void OnChildActorCreated(AActor* ChildActor);
 };
@@ -3,11 +3,20 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Animation/AriaAnimNotify.h"
+#include "Interactable/AriaPhysicalMaterial.h"
 #include "Kismet/GameplayStaticsTypes.h"
+#include "Utils/AriaMovementRecording.h"
+#include "WorldCollision.h"
 #include "AriaCharacterMovement.generated.h"
 
 class AAriaCharacter;
+class ATraversalVolume;
+class UAriaMovementSubsystem;
+struct FAnimUpdateRateParameters;
+enum class EVisibilityBasedAnimTickOption : uint8;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogAriaCharacterMovement, Log, All);
 
@@ -25,6 +34,277 @@ enum ECustomMovementMode
 	CMOVE_MAX UMETA(Hidden),
 };
 
+UENUM(BlueprintType)
+enum class EAriaMovementLod : uint8
+{
+	Full,
+	Reduced,
+	Throttled,
+	Dormant,
+};
+
+/**
+ *	Movement state the animation blueprint reads, published once at the end of every movement tick.
+ *	Plain data only, so the anim graph can read it through property access on worker threads
+ */
+USTRUCT(BlueprintType)
+struct FAriaAnimationSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly) TEnumAsByte<EMovementMode> MovementMode = MOVE_None;
+	UPROPERTY(BlueprintReadOnly) TEnumAsByte<ECustomMovementMode> CustomMovementMode = CMOVE_None;
+	UPROPERTY(BlueprintReadOnly) float Speed = 0.f;
+	UPROPERTY(BlueprintReadOnly) float ClimbLadderDirection = 0.f;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsWalk : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsFalling : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsCrouching : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsWallSliding : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsSliding : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsRopeWalking : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsPushing : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsCrawling : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsClimbLadder : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsIceSliding : 1;
+	UPROPERTY(BlueprintReadOnly) uint8 bIsDashInProgress : 1;
+
+	FAriaAnimationSnapshot()
+		: bIsWalk(false), bIsFalling(false), bIsCrouching(false), bIsWallSliding(false), bIsSliding(false), bIsRopeWalking(false)
+		, bIsPushing(false), bIsCrawling(false), bIsClimbLadder(false), bIsIceSliding(false), bIsDashInProgress(false)
+	{
+	}
+};
+
+/**
+ *	Environment probes shared by every traversal predicate during one movement tick.
+ *	Each probe is traced lazily and stays valid while the frame and the capsule transform don't change
+ */
+struct FAriaMovementProbe
+{
+	uint64 Frame = 0;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	// forward wall hit
+	bool bHasForwardHit = false;
+	float ForwardLength = 0.f;
+	FHitResult ForwardHit;
+	EAriaSurfaceKind ForwardSurface = EAriaSurfaceKind::None;
+
+	// downward clearance hit
+	bool bHasDownHit = false;
+	float DownLength = 0.f;
+	FHitResult DownHit;
+	EAriaSurfaceKind DownSurface = EAriaSurfaceKind::None;
+
+	// mantle front face hit
+	bool bHasLedgeHit = false;
+	float LedgeLength = 0.f;
+	FHitResult LedgeHit;
+};
+
+/**
+ *	Asynchronous probes issued at the end of a movement tick from the predicted next-frame capsule transform
+ */
+struct FAriaProbePrefetch
+{
+	uint64 Frame = 0;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	float ForwardLength = 0.f;
+	float DownLength = 0.f;
+	float LedgeLength = 0.f;
+	FTraceHandle ForwardHandle;
+	FTraceHandle DownHandle;
+	FTraceHandle LedgeHandle;
+};
+
+/**
+ *	Transition probes of one character the movement subsystem traces on the worker threads before any character moves
+ */
+struct FAriaProbeRequest
+{
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	uint8 Probes = 0;
+	float ForwardLength = 0.f;
+	float DownLength = 0.f;
+	float LedgeLength = 0.f;
+	const FCollisionQueryParams* QueryParams = nullptr;
+};
+
+struct FAriaProbeResult
+{
+	FHitResult ForwardHit;
+	FHitResult DownHit;
+	FHitResult LedgeHit;
+};
+
+/**
+ *	Floor found at the capsule location during the current frame, shared by the movement modes and the camera
+ */
+struct FAriaFloorCache
+{
+	uint64 Frame = 0;
+	FVector Location = FVector::ZeroVector;
+	FFindFloorResult Floor;
+	EAriaSurfaceKind Surface = EAriaSurfaceKind::None;
+};
+
+/**
+ *	Movement state published once per movement tick for the camera, so following the hero never touches physics
+ */
+struct FAriaCameraSnapshot
+{
+	uint64 Frame = 0;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	bool bIsGrounded = false;
+	TEnumAsByte<EMovementMode> MovementMode = MOVE_None;
+	uint8 CustomMovementMode = CMOVE_None;
+	float FloorZ = 0.f;
+};
+
+/**
+ *	Mantle thresholds shared by the runtime check and the offline ledge bake
+ */
+struct FAriaMantleQuery
+{
+	float UpOffsetDistance = 0.f;
+	float ReachHeight = 0.f;
+	float MinWallSteepnessCos = 0.f;
+	float MaxSurfaceCos = 0.f;
+	float MaxAlignmentCos = 0.f;
+};
+
+/**
+ *	Ledge the character can mantle onto, with the capsule location it ends on
+ */
+struct FAriaMantleLedge
+{
+	FVector Surface = FVector::ZeroVector;
+	FVector SurfaceNormal = FVector::UpVector;
+	FVector WallNormal = FVector::ZeroVector;
+	FVector Target = FVector::ZeroVector;
+};
+
+/**
+ *	Traversal state quantized for the network: slide timer and dash cooldown in 8 bits each,
+ *	ladder direction in 2 bits and the mantle target only while a mantle is running
+ */
+USTRUCT()
+struct FAriaReplicatedModeState
+{
+	GENERATED_BODY()
+
+	// fraction of MaxSlidingSeconds
+	uint8 SlidingTime = 0;
+
+	// -1, 0 or 1
+	int8 ClimbDirection = 0;
+
+	// fraction of DashCooldown
+	uint8 DashCooldown = 0;
+	bool bIsDashInProgress = false;
+	bool bHasMantleTarget = false;
+	FVector_NetQuantize MantleTarget = FVector::ZeroVector;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+	bool operator==(const FAriaReplicatedModeState& Other) const;
+	bool operator!=(const FAriaReplicatedModeState& Other) const { return !(*this == Other); }
+
+	// ignores the cosmetic ladder direction and one step of quantization error
+	bool MatchesSimulation(const FAriaReplicatedModeState& Other) const;
+
+	static uint8 QuantizeFraction(float Value, float Range);
+	static float DequantizeFraction(uint8 Value, float Range);
+};
+
+template<>
+struct TStructOpsTypeTraits<FAriaReplicatedModeState> : TStructOpsTypeTraitsBase2<FAriaReplicatedModeState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+/**
+ *	Client move data extended with the traversal state the client ended the move in
+ */
+struct FAriaNetworkMoveData : public FCharacterNetworkMoveData
+{
+	typedef FCharacterNetworkMoveData Super;
+
+	FAriaReplicatedModeState ModeState;
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+struct FAriaNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	FAriaNetworkMoveDataContainer();
+
+	FAriaNetworkMoveData MoveData[3];
+};
+
+/**
+ *	Server move response extended with the traversal state the server ended the move in, sent with every correction
+ */
+struct FAriaMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+	typedef FCharacterMoveResponseDataContainer Super;
+
+	FAriaReplicatedModeState ModeState;
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+};
+
+/**
+ *	Saved move carrying the traversal intents. Intents are packed into the custom compressed flags:
+ *	FLAG_Custom_0 move, FLAG_Custom_1 slide, FLAG_Custom_2 crawl, FLAG_Custom_3 dash
+ */
+class FSavedMove_Aria : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PostUpdate(ACharacter* C, EPostUpdateMode PostUpdateMode) override;
+
+private:
+	friend struct FAriaNetworkMoveData;
+
+	uint8 bSavedWantsToMove : 1;
+	uint8 bSavedWantsToSlide : 1;
+	uint8 bSavedWantsToCrawling : 1;
+	uint8 bSavedWantsToDash : 1;
+
+	// movement state at the start of the move, restored when a pending move is combined into it
+	uint8 bSavedIsDashInProgress : 1;
+	float SavedDashCooldownRemaining = 0.f;
+
+	// traversal state at the end of the move, sent for the server to verify
+	FAriaReplicatedModeState SavedModeState;
+};
+
+class FNetworkPredictionData_Client_Aria : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	explicit FNetworkPredictionData_Client_Aria(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class ARIA_API UAriaCharacterMovement : public UCharacterMovementComponent
 {
@@ -32,6 +312,9 @@ class ARIA_API UAriaCharacterMovement : public UCharacterMovementComponent
 
 public:
 	UAriaCharacterMovement();
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void AddInputVector(FVector WorldVector, bool bForce = false) override;
+	virtual void RequestDirectMove(const FVector& MoveVelocity, bool bForceMaxSpeed) override;
 
 	// Blueprint Animation
 	UFUNCTION(BlueprintPure) float GetSpeed() const;
@@ -43,7 +326,81 @@ public:
 	UFUNCTION(BlueprintPure) bool IsCrawling() const { return IsCustomMovementMode(CMOVE_Crawling); }
 	UFUNCTION(BlueprintPure) bool IsClimbLadder() const { return IsCustomMovementMode(CMOVE_ClimbLadder); }
 	UFUNCTION(BlueprintPure) bool IsIceSliding() const { return IsCustomMovementMode(CMOVE_IceSliding); }
-	UFUNCTION(BlueprintPure) float GetClimbLadderDirection();
+	UFUNCTION(BlueprintPure) float GetClimbLadderDirection() const { return LastClimbDirection; }
+	UPROPERTY(BlueprintReadOnly, Transient, Category="Animation") FAriaAnimationSnapshot AnimationSnapshot;
+	UFUNCTION(BlueprintPure, meta=(BlueprintThreadSafe)) FAriaAnimationSnapshot GetAnimationSnapshot() const { return AnimationSnapshot; }
+
+	// Probe
+	UFUNCTION(BlueprintPure) int32 GetSceneQueryCount() const;
+	const FFindFloorResult& GetCachedFloor() const;
+	UPROPERTY(EditDefaultsOnly, Category="Probe") bool bUseAsyncProbes = false;
+	UPROPERTY(EditDefaultsOnly, Category="Probe", meta=(EditCondition="bUseAsyncProbes")) float AsyncProbeLocationTolerance = 1.f;
+	UPROPERTY(EditDefaultsOnly, Category="Probe") bool bClassifySurfacesByTag = true;
+	// traces, sweeps, overlaps and floor searches per move, 0 for no limit
+	UPROPERTY(EditDefaultsOnly, Category="Probe", meta=(ClampMin=0)) int32 SceneQueryBudget = 32;
+	// only moves nobody replays or verifies defer, a predicted move has to run the same guards on both ends
+	UPROPERTY(EditDefaultsOnly, Category="Probe") bool bDeferLowPriorityTransitions = true;
+	bool IsOverSceneQueryBudget() const;
+	bool CanDeferTransitions() const;
+	bool MakeProbeRequest(FAriaProbeRequest& OutRequest) const;
+	void TraceProbeRequest(const FAriaProbeRequest& Request, FAriaProbeResult& OutResult) const;
+	void ApplyProbeResult(const FAriaProbeRequest& Request, const FAriaProbeResult& Result);
+
+	// Animation Events
+	void HandleAnimEvent(EAriaAnimEvent Event);
+
+	// Camera
+	const FAriaCameraSnapshot& GetCameraSnapshot() const { return CameraSnapshot; }
+	FVector GetCameraTargetLocation() const;
+	void AddCameraTickDependent(FTickFunction& TickFunction);
+	void RemoveCameraTickDependent(FTickFunction& TickFunction);
+
+	// LOD
+	UPROPERTY(EditDefaultsOnly, Category="LOD") bool bEnableMovementLod = true;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) float ReducedLodDistance = 2500.f;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) float ThrottledLodDistance = 5000.f;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) float DormantLodDistance = 10000.f;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) float LodHysteresisDistance = 500.f;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) float ReducedLodTickRate = 30.f;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) float ThrottledLodTickRate = 15.f;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) float ReducedLodMaxTimeStep = .1f;
+	UPROPERTY(EditDefaultsOnly, Category="LOD", meta=(EditCondition="bEnableMovementLod")) int32 ThrottledLodTransitionInterval = 4;
+	UFUNCTION(BlueprintPure) EAriaMovementLod GetMovementLod() const { return MovementLod; }
+	EAriaMovementLod EvaluateMovementLod(float ViewDistance, bool bIsVisible) const;
+	void SetMovementLod(EAriaMovementLod Lod);
+	float GetLodTickInterval() const { return LodTickInterval; }
+	bool HasPendingMovement() const;
+
+	// Animation LOD
+	UPROPERTY(EditDefaultsOnly, Category="Animation LOD") bool bEnableAnimationLod = true;
+	// frames skipped between animation updates for each mesh LOD, the skipped frames are interpolated
+	UPROPERTY(EditDefaultsOnly, Category="Animation LOD", meta=(EditCondition="bEnableAnimationLod")) TArray<int32> AnimationFrameSkipPerLod = { 0, 1, 2, 3 };
+	// lowest mesh LOD, and so the fewest evaluated bones, of the Reduced and Throttled tiers
+	UPROPERTY(EditDefaultsOnly, Category="Animation LOD", meta=(EditCondition="bEnableAnimationLod", ClampMin=0)) int32 ReducedAnimationMinLod = 1;
+	UPROPERTY(EditDefaultsOnly, Category="Animation LOD", meta=(EditCondition="bEnableAnimationLod", ClampMin=0)) int32 ThrottledAnimationMinLod = 2;
+	void ConfigureAnimationUpdateRate(FAnimUpdateRateParameters* Params) const;
+
+	// Fixed Time Step
+	UPROPERTY(EditDefaultsOnly, Category="Fixed Time Step") bool bUseFixedTimeStep = false;
+	UPROPERTY(EditDefaultsOnly, Category="Fixed Time Step", meta=(EditCondition="bUseFixedTimeStep", ClampMin=1)) float FixedTimeStepRate = 60.f;
+	UPROPERTY(EditDefaultsOnly, Category="Fixed Time Step", meta=(EditCondition="bUseFixedTimeStep", ClampMin=1)) int32 MaxFixedStepsPerTick = 4;
+	UPROPERTY(EditDefaultsOnly, Category="Fixed Time Step", meta=(EditCondition="bUseFixedTimeStep")) bool bInterpolateFixedTimeStep = true;
+	bool IsFixedTimeStepActive() const;
+
+	// Batched Tick
+	bool IsTickBatched() const { return bIsTickBatched; }
+	void SetTickBatched(bool bBatched);
+
+	// Recording
+	void StartRecording(const FString& Filename);
+	void StopRecording();
+	bool IsRecording() const { return Recorder.IsValid(); }
+	void RestoreRecordedState(const FAriaMovementRecordHeader& Header);
+
+	// Traversal Volumes
+	UPROPERTY(EditDefaultsOnly, Category="Traversal Volumes") bool bRequireTraversalVolumes = false;
+	void EnterTraversalVolume(const ATraversalVolume* Volume);
+	void ExitTraversalVolume(const ATraversalVolume* Volume);
 
 	// Move
 	bool bWantsToMove;
@@ -90,6 +447,9 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category="Mantle") float MantleMaxSurfaceAngle = 40.f;
 	UPROPERTY(EditDefaultsOnly, Category="Mantle") float MantleMaxAlignmentAngle = 55.f;
 	UPROPERTY(EditDefaultsOnly, Category="Mantle") TObjectPtr<UAnimMontage> MantleAnim;
+	FAriaMantleQuery MakeMantleQuery() const;
+	static bool IsMantleWall(const FAriaMantleQuery& Query, const FHitResult& FrontResult, const FVector& ForwardVector);
+	static bool FindMantleLedge(const UWorld* World, const FCollisionQueryParams& QueryParams, const FAriaMantleQuery& Query, const FHitResult& FrontResult, const FVector& FrontStart, const FVector& ForwardVector, float CapsuleRadius, float CapsuleHalfHeight, FAriaMantleLedge& OutLedge);
 
 	// Climb Ladder
 	UPROPERTY(EditDefaultsOnly, Category="Climb Ladder") float MinHeightToClimbLadder = 200.f;
@@ -116,30 +476,139 @@ public:
 	virtual bool DoJump(bool bReplayingMoves) override;
 	virtual bool CanAttemptJump() const override;
 	virtual float GetMaxSpeed() const override;
+	virtual void FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bCanUseCachedLocation, const FHitResult* DownwardSweepResult = nullptr) const override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	FAriaReplicatedModeState MakeReplicatedModeState() const;
 
 protected:
 	virtual void InitializeComponent() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+	void PhysCustomMode(float DeltaTime, int32 Iterations);
+	virtual bool MoveUpdatedComponentImpl(const FVector& Delta, const FQuat& NewRotation, bool bSweep, FHitResult* OutHit, ETeleportType Teleport) override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
 
 private:
+	friend class FSavedMove_Aria;
+
+	// Replication
+	FAriaNetworkMoveDataContainer NetworkMoveDataContainer;
+	FAriaMoveResponseDataContainer MoveResponseDataContainer;
+	UPROPERTY(ReplicatedUsing=OnRep_ModeState) FAriaReplicatedModeState ReplicatedModeState;
+	UFUNCTION() void OnRep_ModeState();
+	void ApplyReplicatedModeState(const FAriaReplicatedModeState& State);
+
+	// LOD
+	EAriaMovementLod MovementLod = EAriaMovementLod::Full;
+	float LodTickInterval = 0.f;
+	float FullLodMaxTimeStep = 0.f;
+	uint32 TransitionTickCounter = 0;
+
+	// Fixed Time Step
+	float FixedStepAccumulator = 0.f;
+	FVector FixedStepPreviousLocation = FVector::ZeroVector;
+	FVector FixedStepVisualOffset = FVector::ZeroVector;
+	bool bHasFixedStepVisualOffset = false;
+	void PhysFixedTimeStep(float DeltaTime, int32 Iterations);
+	void UpdateFixedStepInterpolation();
+
+	// Animation
+	void UpdateClimbDirection();
+	void PublishAnimationSnapshot();
+
+	// Animation LOD
+	EVisibilityBasedAnimTickOption DefaultVisibilityBasedAnimTickOption{};
+	uint8 PendingAnimEvents = 0;
+	void ApplyAnimationLod();
+	bool GetMontageEvent(const UAnimMontage* Montage, EAriaAnimEvent& OutEvent) const;
+	UFUNCTION() void OnMovementMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+
+	// Camera
+	FAriaCameraSnapshot CameraSnapshot;
+	void PublishCameraSnapshot();
+
+	// Batched Tick
+	bool bIsTickBatched = false;
+	void ApplyComponentTickSettings();
+
+	// Recording
+	TUniquePtr<FAriaMovementRecordWriter> Recorder;
+	FAriaMovementRecordFrame RecordFrame;
+	void RecordTickInput(float DeltaSeconds);
+	void RecordTickResult();
+
+	// Simulated Proxy
+	void PhysSimulatedProxy(float DeltaTime);
+	void ApplySimulatedCapsuleSize();
+
 	UPROPERTY(Transient) TObjectPtr<AAriaCharacter> AriaCharacterOwner;
+	UPROPERTY(Transient) TObjectPtr<UAriaMovementSubsystem> MovementSubsystem;
+
+	// Probe
+	mutable FAriaMovementProbe Probe;
+	mutable FAriaFloorCache FloorCache;
+	mutable uint64 SceneQueryFrame = 0;
+	mutable int32 SceneQueryCount = 0;
+	mutable int32 MoveSceneQueryCount = 0;
+	mutable const TCHAR* SceneQueryScope = TEXT("Physics");
+	mutable TArray<TPair<const TCHAR*, int32>, TInlineAllocator<16>> SceneQueryChain;
+	mutable bool bSceneQueryBudgetReported = false;
+	const FHitResult& ProbeForward(float Length = 0.f) const;
+	const FHitResult& ProbeDown(float Length = 0.f) const;
+	const FHitResult& ProbeLedge(float Length = 0.f) const;
+	void RefreshProbe() const;
+	void InvalidateProbe();
+	float GetForwardProbeLength() const;
+	float GetDownProbeLength() const;
+	float GetLedgeProbeLength() const;
+	FAriaProbePrefetch ProbePrefetch;
+	void PrefetchProbes();
+	void ConsumePrefetchedProbes();
+	bool ConsumePrefetchedHit(const FTraceHandle& TraceHandle, FHitResult& OutHit) const;
+	EAriaSurfaceKind ClassifySurface(const FHitResult& HitResult) const;
+	static bool IsProbeHitWithin(const FHitResult& HitResult, float Length);
+	void CountSceneQuery() const;
+	void ResetMoveSceneQueries();
+	void ReportSceneQueryBudget() const;
+	bool TraceLine(FHitResult& OutHit, const FVector& Start, const FVector& End, FName TraceTag, const TStatId& StatId) const;
+	bool OverlapCapsule(const FVector& Location, const FCollisionShape& CollisionShape, FName TraceTag, const TStatId& StatId) const;
+
+	// Traversal Volumes
+	TArray<TObjectKey<ATraversalVolume>, TInlineAllocator<4>> TraversalVolumes;
+	uint8 TraversalVolumeCounts[AriaSurfaceKindCount] = {};
+	bool IsInsideTraversalVolume(EAriaSurfaceKind SurfaceKind) const;
+
+	// Mode Transitions
+	using FTransitionGuard = void (UAriaCharacterMovement::*)();
+	static const FTransitionGuard TransitionGuards[];
+	void UpdateModeTransitions();
+	uint32 GetReachableTransitions() const;
+	bool IsAtRest() const;
 
 	// Wall Slide
 	void TryWallSlide();
 	void PhysWallSlide(float DeltaTime, int32 Iterations);
-	FVector EndDownVector(const FVector& Start) const;
-	FVector EndForwardVector(const FVector& Start) const;
+	float GetWallSlideFloorDistance() const;
+	float GetWallSlideWallDistance() const;
 
 	// Slide
 	float SlidingTime = 0.f;
+	void TryEnterSlide();
+	void TryExitSlide();
 	void EnterSlide();
 	void ExitSlide();
 	void PhysSlide(float DeltaTime, int32 Iterations);
-	bool CanSlide(FFindFloorResult& FloorHit) const;
+	bool CanSlide() const;
 
 	// Rope Walking
 	void TryRopeWalking();
-	bool CanRopeWalking(FHitResult& HitResult) const;
+	bool CanRopeWalking() const;
 	void PhysRopeWalking(float DeltaTime, int32 Iterations);
 
 	// Hard Landing
@@ -155,27 +624,30 @@ private:
 
 	// Crawling
 	bool bIsCrawlingAnimFinished = true;
+	void TryEnterCrawling();
+	void TryExitCrawling();
 	void EnterCrawling();
 	void ExitCrawling();
 	void OnCrawlingAnimFinished();
-	bool CanCrawling(FFindFloorResult& FloorResult) const;
+	bool CanCrawling() const;
 	void PhysCrawling(float DeltaTime, int32 Iterations);
 
 	// Mantle
 	int RootMotionSourceID;
 	TSharedPtr<FRootMotionSource_MoveToForce> RootMotionSource;
+	FAriaMantleQuery MantleQuery;
 	void TryMantle();
 	void OnMantleAnimFinished();
 
 	// Climb Ladder
 	float LastClimbDirection = 0.f;
 	void TryClimbLadder();
-	bool CanClimbLadder(FHitResult& LadderHit) const;
+	bool CanClimbLadder() const;
 	void PhysClimbLadder(float DeltaTime, int32 Iterations);
 
 	// Dash
 	bool bIsDashInProgress = false;
-	float DashStartTime;
+	float DashCooldownRemaining = 0.f;
 	void TryDash();
 	bool CanDash();
 	void PerformDash();
@@ -187,6 +659,7 @@ private:
 	void PhysIceSliding(float DeltaTime, int32 Iterations);
 
 	// Helpers
+	bool IsSimulatedProxy() const;
 	bool IsCustomMovementMode(const ECustomMovementMode InCustomMovementMode) const;
 	bool CannotPerformPhysMovement() const;
 	bool CanPerformFrameTickMovement(const float RemainingTime, const int32 Iterations) const;
@@ -194,23 +667,5 @@ private:
 	float GetCapsuleHalfHeight() const;
 	void SetCollisionSizeToSlidingDimensions();
 	bool RestoreDefaultCollisionDimensions();
-	void InitAnimations();
-	template<typename AnimNotify>
-	TObjectPtr<AnimNotify> FindNotifyByClass(const TObjectPtr<UAnimSequenceBase> Animation)
-	{
-		if (!Animation)
-		{
-			return nullptr;
-		}
-
-		for (FAnimNotifyEvent NotifyEvent : Animation->Notifies)
-		{
-			if (const auto AnimationNotify = Cast<AnimNotify>(NotifyEvent.Notify))
-			{
-				return AnimationNotify;
-			}
-		}
-
-		return nullptr;
-	}
+	void PlayMovementMontage(UAnimMontage* Montage);
 };
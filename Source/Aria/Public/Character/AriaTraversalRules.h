@@ -0,0 +1,161 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+/**
+ *	Traversal rules shared by the character movement and the crowd runners
+ */
+struct FAriaTraversalRules
+{
+	/**
+	 *	Distance to the wall within which a wall slide can start or go on
+	 */
+	static FORCEINLINE float GetWallSlideWallDistance(const float CapsuleRadius)
+	{
+		return CapsuleRadius * 2.2f;
+	}
+
+	/**
+	 *	Distance to the floor below which a wall slide can't start or go on
+	 */
+	static FORCEINLINE float GetWallSlideFloorDistance(const float CapsuleRadius, const float MinHeightToSlide)
+	{
+		return CapsuleRadius + MinHeightToSlide;
+	}
+
+	/**
+	 *	Checks if the wall slide goes on with the probed wall and floor
+	 */
+	static FORCEINLINE bool CanKeepWallSliding(const bool bHasWall, const bool bHasFloor)
+	{
+		return bHasWall && !bHasFloor;
+	}
+
+	/**
+	 *	Velocity along the wall with the wall slide gravity applied
+	 */
+	static FORCEINLINE FVector GetWallSlideVelocity(const FVector& Velocity, const FVector& WallNormal, const FVector& Acceleration, const float GravityZ, const UCurveFloat* GravityCurve, const float DeltaTime)
+	{
+		FVector Result = FVector::VectorPlaneProject(Velocity, WallNormal);
+		const bool bVelocityUp = Result.Z > 0.f;
+		const float TangentAccel = Acceleration.GetSafeNormal2D() | Result.GetSafeNormal2D();
+		Result.Z += GravityZ * GravityCurve->GetFloatValue(bVelocityUp ? 0.f : TangentAccel) * DeltaTime;
+		return Result;
+	}
+
+	/**
+	 *	Velocity after the impulse that starts a slide
+	 */
+	static FORCEINLINE FVector GetEnterSlideVelocity(const FVector& Velocity, const float EnterSlideImpulse)
+	{
+		return Velocity + Velocity.GetSafeNormal2D() * EnterSlideImpulse;
+	}
+
+	/**
+	 *	Velocity after braking like UCharacterMovementComponent::ApplyVelocityBraking, in substeps and without reversing.
+	 *	BrakingFriction already has the braking friction factor applied
+	 */
+	static FORCEINLINE FVector GetBrakingVelocity(const FVector& Velocity, const float BrakingFriction, const float BrakingDeceleration, const float BrakingSubStepTime, const float DeltaTime)
+	{
+		const float Friction = FMath::Max(0.f, BrakingFriction);
+		const float Deceleration = FMath::Max(0.f, BrakingDeceleration);
+		if (Velocity.IsZero() || DeltaTime < UCharacterMovementComponent::MIN_TICK_TIME || (Friction == 0.f && Deceleration == 0.f))
+		{
+			return Velocity;
+		}
+
+		const FVector ReverseAcceleration = -Deceleration * Velocity.GetSafeNormal();
+		const float MaxTimeStep = FMath::Clamp(BrakingSubStepTime, 1.f / 75.f, 1.f / 20.f);
+		FVector Result = Velocity;
+		float RemainingTime = DeltaTime;
+		while (RemainingTime >= UCharacterMovementComponent::MIN_TICK_TIME)
+		{
+			// zero friction is a constant deceleration, it needs no substeps
+			const float TimeStep = RemainingTime > MaxTimeStep && Friction != 0.f ? FMath::Min(MaxTimeStep, RemainingTime * .5f) : RemainingTime;
+			RemainingTime -= TimeStep;
+			Result += (-Friction * Result + ReverseAcceleration) * TimeStep;
+			if ((Result | Velocity) <= 0.f)
+			{
+				return FVector::ZeroVector;
+			}
+		}
+
+		const float SpeedSquared = Result.SizeSquared();
+		return SpeedSquared <= UE_KINDA_SMALL_NUMBER || (Deceleration != 0.f && SpeedSquared <= FMath::Square(UCharacterMovementComponent::BRAKE_TO_STOP_VELOCITY)) ? FVector::ZeroVector : Result;
+	}
+
+	/**
+	 *	Same tolerance as UMovementComponent::IsExceedingMaxSpeed
+	 */
+	static FORCEINLINE bool IsExceedingMaxSpeed(const FVector& Velocity, const float MaxSpeed)
+	{
+		return Velocity.SizeSquared() > FMath::Square(FMath::Max(0.f, MaxSpeed)) * 1.01f;
+	}
+
+	/**
+	 *	Velocity like UCharacterMovementComponent::CalcVelocity without a requested velocity, for the crowd runners that don't run the engine movement.
+	 *	Acceleration is either zero or at full analog input, BrakingFriction already has the braking friction factor applied
+	 */
+	static FORCEINLINE FVector GetVelocity(const FVector& Velocity, const FVector& Acceleration, const float MaxSpeed, const float Friction, const bool bFluid, const float BrakingFriction, const float BrakingDeceleration, const float BrakingSubStepTime, const float DeltaTime)
+	{
+		if (DeltaTime < UCharacterMovementComponent::MIN_TICK_TIME)
+		{
+			return Velocity;
+		}
+
+		const float ClampedFriction = FMath::Max(0.f, Friction);
+		const bool bZeroAcceleration = Acceleration.IsZero();
+		const bool bVelocityOverMax = IsExceedingMaxSpeed(Velocity, MaxSpeed);
+		FVector Result = Velocity;
+
+		// brake without acceleration or down to the max speed, friction turns the velocity toward the acceleration otherwise
+		if (bZeroAcceleration || bVelocityOverMax)
+		{
+			Result = GetBrakingVelocity(Velocity, BrakingFriction, BrakingDeceleration, BrakingSubStepTime, DeltaTime);
+			if (bVelocityOverMax && Result.SizeSquared() < FMath::Square(MaxSpeed) && (Acceleration | Velocity) > 0.f)
+			{
+				Result = Velocity.GetSafeNormal() * MaxSpeed;
+			}
+		}
+		else
+		{
+			Result -= (Result - Acceleration.GetSafeNormal() * Result.Size()) * FMath::Min(DeltaTime * ClampedFriction, 1.f);
+		}
+
+		if (bFluid)
+		{
+			Result *= 1.f - FMath::Min(ClampedFriction * DeltaTime, 1.f);
+		}
+
+		if (!bZeroAcceleration)
+		{
+			const float NewMaxSpeed = IsExceedingMaxSpeed(Result, MaxSpeed) ? Result.Size() : MaxSpeed;
+			Result += Acceleration * DeltaTime;
+			Result = Result.GetClampedToMaxSize(NewMaxSpeed);
+		}
+
+		return Result;
+	}
+
+	/**
+	 *	Checks if the slide ran out of time
+	 */
+	static FORCEINLINE bool HasSlideExpired(const float SlidingTime, const float MaxSlidingSeconds)
+	{
+		return MaxSlidingSeconds > 0.f && SlidingTime >= MaxSlidingSeconds;
+	}
+
+	/**
+	 *	Velocity along the ladder, ClimbInput is -1 to climb down and 1 to climb up
+	 */
+	static FORCEINLINE FVector GetClimbLadderVelocity(const FVector& Velocity, const FVector& LadderNormal, const float MaxClimbLadderSpeed, const float ClimbInput)
+	{
+		FVector Result = FVector::VectorPlaneProject(Velocity, LadderNormal);
+		Result.Z = MaxClimbLadderSpeed * ClimbInput;
+		return Result;
+	}
+};
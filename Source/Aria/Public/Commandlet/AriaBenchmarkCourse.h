@@ -0,0 +1,77 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interactable/AriaPhysicalMaterial.h"
+
+class AAriaCharacter;
+class UAriaCharacterMovement;
+class UStaticMesh;
+
+/**
+ *	Generated course the movement commandlets run characters over, it only depends on the seed so runs compare between commits.
+ *	Every block spans all lanes, one lane per character so they never block each other
+ */
+struct ARIA_API FAriaBenchmarkCourse
+{
+	static constexpr int32 SegmentCount = 24;
+	static constexpr float SegmentLength = 800.f;
+	static constexpr float LaneSpacing = 300.f;
+	static constexpr float PitDepth = 800.f;
+
+	UWorld* World = nullptr;
+	UStaticMesh* Cube = nullptr;
+	const UAriaCharacterMovement* Movement = nullptr;
+	int32 LaneCount = 0;
+	float EndX = 0.f;
+	TMap<EAriaSurfaceKind, UAriaPhysicalMaterial*> Materials;
+
+	/**
+	 *	Creates an empty game world that plays, so begin play and the subsystems run like in a level
+	 */
+	static UWorld* CreateWorld(const TCHAR* Name);
+	static void DestroyWorld(UWorld* World);
+
+	/**
+	 *	Mode the movement ticks in, named like the movement mode enums
+	 */
+	static FString GetModeName(const UAriaCharacterMovement* Movement);
+
+	/**
+	 *	Builds the course from the seed, sets where it ends along X
+	 */
+	void Build(int32 Seed);
+
+	FVector GetStartLocation(int32 Lane) const;
+
+	/**
+	 *	Spawns a character at the start of the lane, its movement is ticked by the caller only
+	 */
+	AAriaCharacter* SpawnCharacter(UClass* CharacterClass, int32 Lane) const;
+
+private:
+	void AddBlock(const FVector& Min, const FVector& Max, EAriaSurfaceKind SurfaceKind = EAriaSurfaceKind::None, FName Tag = NAME_None);
+	void AddFloor(float StartX, float EndX, float TopZ, EAriaSurfaceKind SurfaceKind = EAriaSurfaceKind::None, FName Tag = NAME_None);
+	UAriaPhysicalMaterial* GetMaterial(EAriaSurfaceKind SurfaceKind);
+};
+
+/**
+ *	Scripted input of one lane, always running forward with random jumps, slides, crawls and dashes
+ */
+struct ARIA_API FAriaBenchmarkScript
+{
+	static constexpr int32 StuckCheckFrames = 180;
+
+	FRandomStream Stream;
+	FVector StartLocation = FVector::ZeroVector;
+	float CheckpointX = 0.f;
+	int32 SlideFrames = 0;
+
+	FAriaBenchmarkScript(int32 Seed, const FVector& InStartLocation);
+
+	/**
+	 *	Starts over at the end of the course or when stuck in a pit, then applies the input of the frame
+	 */
+	void Step(AAriaCharacter* Character, UAriaCharacterMovement* Movement, int32 Frame, float CourseEndX);
+};
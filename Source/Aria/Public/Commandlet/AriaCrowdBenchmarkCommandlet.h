@@ -0,0 +1,24 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AriaCrowdBenchmarkCommandlet.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAriaCrowdBenchmark, Log, All);
+
+/**
+ *	Compares the frame cost of N characters running with the full movement component against N crowd runners.
+ *	Usage: -run=AriaCrowdBenchmark -Map=/Game/Maps/Level -Character=/Game/Blueprints/BP_Character.BP_Character_C [-Count=200] [-Frames=600]
+ */
+UCLASS()
+class ARIA_API UAriaCrowdBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAriaCrowdBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,26 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AriaMovementBenchmarkCommandlet.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAriaMovementBenchmark, Log, All);
+
+/**
+ *	Runs characters with scripted input over a generated course and reports the tick cost of every movement mode.
+ *	The course and the input only depend on the seed, so runs of the same seed compare between commits.
+ *	Also measures the frames from a move input to the first motion of the follow camera.
+ *	Usage: -run=AriaMovementBenchmark -nullrhi -Character=/Game/Blueprints/BP_Character.BP_Character_C [-Count=32] [-Frames=3600] [-Seed=1] [-Csv=<file>]
+ */
+UCLASS()
+class ARIA_API UAriaMovementBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAriaMovementBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,24 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AriaMovementReplayCommandlet.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAriaMovementReplay, Log, All);
+
+/**
+ *	Feeds a movement recording back into its character, reports the first tick that diverges from the recording and the time of every tick.
+ *	Usage: -run=AriaMovementReplay -nullrhi -Recording=<file> [-Tolerance=1] [-Csv=<file>]
+ */
+UCLASS()
+class ARIA_API UAriaMovementReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAriaMovementReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,25 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AriaNetBandwidthCommandlet.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAriaNetBandwidth, Log, All);
+
+/**
+ *	Runs characters with scripted input over the benchmark course and reports the bytes per second each traversal mode adds
+ *	on top of the engine move data, per character and over the time spent in the mode.
+ *	Usage: -run=AriaNetBandwidth -nullrhi -Character=/Game/Blueprints/BP_Character.BP_Character_C [-Count=8] [-Seconds=60] [-MoveRate=60] [-UpdateRate=30] [-Seed=1] [-Csv=<file>]
+ */
+UCLASS()
+class ARIA_API UAriaNetBandwidthCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAriaNetBandwidthCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,24 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MantleLedgeBakeCommandlet.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMantleLedgeBake, Log, All);
+
+/**
+ *	Bakes the mantle ledges of the static geometry of a level into Content/MantleLedges/<Map>.ledges.
+ *	Usage: -run=MantleLedgeBake -Map=/Game/Maps/Level -Character=/Game/Blueprints/BP_Character.BP_Character_C [-PlaneY=0] [-Step=10] [-CellSize=200]
+ */
+UCLASS()
+class ARIA_API UMantleLedgeBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMantleLedgeBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,123 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Interactable/AriaPhysicalMaterial.h"
+#include "AriaCrowdFragments.generated.h"
+
+class AAriaCharacter;
+class UCurveFloat;
+
+UENUM()
+enum class EAriaCrowdMode : uint8
+{
+	Running,
+	Falling,
+	WallSliding,
+	Sliding,
+	ClimbLadder,
+	IceSliding,
+};
+
+USTRUCT()
+struct ARIA_API FAriaCrowdLocationFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// capsule center
+	FVector Location = FVector::ZeroVector;
+};
+
+USTRUCT()
+struct ARIA_API FAriaCrowdVelocityFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FVector Velocity = FVector::ZeroVector;
+};
+
+USTRUCT()
+struct ARIA_API FAriaCrowdModeFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	EAriaCrowdMode Mode = EAriaCrowdMode::Falling;
+
+	// -1 to run along -X, 1 to run along +X
+	float Direction = 1.f;
+	float ModeTime = 0.f;
+
+	// set by UAriaCrowdSubsystem::SetWantsToSlide, kept until the runner can slide
+	bool bWantsToSlide = false;
+};
+
+/**
+ *	Wall ahead and floor below the runner, refreshed every frame by the probe phase
+ */
+USTRUCT()
+struct ARIA_API FAriaCrowdProbeFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	bool bHasWall = false;
+	float WallDistance = 0.f;
+	FVector WallNormal = FVector::ZeroVector;
+	EAriaSurfaceKind WallSurface = EAriaSurfaceKind::None;
+
+	bool bHasFloor = false;
+	float FloorDistance = 0.f;
+	EAriaSurfaceKind FloorSurface = EAriaSurfaceKind::None;
+};
+
+/**
+ *	Tuning shared by every runner of one character class, copied from its movement defaults
+ */
+USTRUCT()
+struct ARIA_API FAriaCrowdTraversalParams : public FMassSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY() float CapsuleRadius = 0.f;
+	UPROPERTY() float CapsuleHalfHeight = 0.f;
+	UPROPERTY() float GravityZ = 0.f;
+	UPROPERTY() float MaxRunSpeed = 0.f;
+	UPROPERTY() float RunAcceleration = 0.f;
+	UPROPERTY() float BrakingFrictionFactor = 0.f;
+	UPROPERTY() bool bUseSeparateBrakingFriction = false;
+	UPROPERTY() float BrakingFriction = 0.f;
+	UPROPERTY() float BrakingSubStepTime = 0.f;
+	UPROPERTY() float MinHeightToSlide = 0.f;
+	UPROPERTY() TObjectPtr<UCurveFloat> WallSlideGravityCurve;
+	UPROPERTY() float MinSpeedToEnterSlide = 0.f;
+	UPROPERTY() float EnterSlideImpulse = 0.f;
+	UPROPERTY() float SlideFriction = 0.f;
+	UPROPERTY() float MaxSlidingSeconds = 0.f;
+	UPROPERTY() float ForwardDistanceToCheckLadder = 0.f;
+	UPROPERTY() float MaxClimbLadderSpeed = 0.f;
+	UPROPERTY() float IceSlideFriction = 0.f;
+	UPROPERTY() float IceSlidingBrakingFrictionFactor = 0.f;
+	UPROPERTY() float MaxIceSlidingAcceleration = 0.f;
+	UPROPERTY() float MaxIceSlidingSpeed = 0.f;
+	UPROPERTY() bool bClassifySurfacesByTag = false;
+	UPROPERTY() FName RopeTag;
+	UPROPERTY() FName ClimbLadderTag;
+	UPROPERTY() FName IceTag;
+	UPROPERTY() FName MovableTag;
+
+	/**
+	 *	Surface kinds of a probe hit, same rules as the character movement
+	 */
+	EAriaSurfaceKind ClassifySurface(const FHitResult& HitResult) const;
+
+	/**
+	 *	Braking friction of a mode before the braking friction factor, same rule as UCharacterMovementComponent::CalcVelocity
+	 */
+	FORCEINLINE float GetBrakingFriction(const float Friction) const
+	{
+		return bUseSeparateBrakingFriction ? BrakingFriction : Friction;
+	}
+
+	static FAriaCrowdTraversalParams MakeFromCharacter(const TSubclassOf<AAriaCharacter> CharacterClass);
+};
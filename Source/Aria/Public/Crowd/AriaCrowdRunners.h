@@ -0,0 +1,44 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "GameFramework/Actor.h"
+#include "AriaCrowdRunners.generated.h"
+
+class AAriaCharacter;
+class UInstancedStaticMeshComponent;
+
+/**
+ *	Spawns a row of background runners that traverse the level like the hero and draws them as mesh instances
+ */
+UCLASS()
+class ARIA_API AAriaCrowdRunners : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AAriaCrowdRunners();
+
+	UPROPERTY(EditAnywhere, Category="Component") TObjectPtr<UInstancedStaticMeshComponent> MeshComponent;
+	UPROPERTY(EditAnywhere, Category="Crowd") TSubclassOf<AAriaCharacter> CharacterClass;
+	UPROPERTY(EditAnywhere, Category="Crowd", meta=(ClampMin=1)) int32 Count = 50;
+	UPROPERTY(EditAnywhere, Category="Crowd") float Spacing = 150.f;
+	// -1 to run along -X, 1 to run along +X
+	UPROPERTY(EditAnywhere, Category="Crowd") float Direction = 1.f;
+	// seconds between the slides of the row, 0 to never slide
+	UPROPERTY(EditAnywhere, Category="Crowd", meta=(ClampMin=0)) float SlideInterval = 4.f;
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	TArray<FMassEntityHandle> Runners;
+	TArray<FVector> RunnerLocations;
+	TArray<FTransform> InstanceTransforms;
+	float SlideTime = 0.f;
+};
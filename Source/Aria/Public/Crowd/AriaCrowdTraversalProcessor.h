@@ -0,0 +1,28 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "AriaCrowdTraversalProcessor.generated.h"
+
+/**
+ *	Moves crowd runners with the hero traversal rules. Probes run in parallel against the physics scene,
+ *	the mode rules and the integration then run over the contiguous fragment arrays of each chunk
+ */
+UCLASS()
+class ARIA_API UAriaCrowdTraversalProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UAriaCrowdTraversalProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+private:
+	FMassEntityQuery ProbeQuery;
+	FMassEntityQuery TraversalQuery;
+};
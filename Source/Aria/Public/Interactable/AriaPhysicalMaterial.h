@@ -0,0 +1,42 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "AriaPhysicalMaterial.generated.h"
+
+UENUM(meta=(Bitflags, UseEnumValuesAsMaskValuesInEditor="true"))
+enum class EAriaSurfaceKind : uint8
+{
+	None = 0 UMETA(Hidden),
+	Rope = 1 << 0,
+	Ladder = 1 << 1,
+	Ice = 1 << 2,
+	Movable = 1 << 3,
+};
+ENUM_CLASS_FLAGS(EAriaSurfaceKind);
+
+// one bit per surface kind, sizes the tables indexed by the bit of a kind
+constexpr int32 AriaSurfaceKindCount = 4;
+static_assert(static_cast<uint8>(EAriaSurfaceKind::Movable) == 1 << (AriaSurfaceKindCount - 1), "AriaSurfaceKindCount must cover every surface kind");
+
+/**
+ *	Physical material that tells the traversal code which kind of surface a hit primitive is
+ */
+UCLASS()
+class ARIA_API UAriaPhysicalMaterial : public UPhysicalMaterial
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category="Surface", meta=(Bitmask, BitmaskEnum="/Script/Aria.EAriaSurfaceKind")) int32 SurfaceKinds = 0;
+
+	EAriaSurfaceKind GetSurfaceKinds() const { return static_cast<EAriaSurfaceKind>(SurfaceKinds); }
+	static EAriaSurfaceKind GetSurfaceKinds(const FHitResult& HitResult, bool& bOutHasSurfaceMaterial);
+
+	/**
+	 *	Surface kinds from the actor tags, for content that has no surface physical material yet
+	 */
+	static EAriaSurfaceKind GetTaggedSurfaceKinds(const AActor* Actor, FName RopeTag, FName LadderTag, FName IceTag, FName MovableTag);
+};
@@ -0,0 +1,59 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Volume.h"
+#include "CameraBoundsVolume.generated.h"
+
+USTRUCT()
+struct FDeadFollowZone
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere) bool bEnabled = true;
+	UPROPERTY(EditAnywhere) float LeftOffset = 100.f;
+	UPROPERTY(EditAnywhere) float RightOffset = 100.f;
+	UPROPERTY(EditAnywhere) float TopOffset = 100.f;
+};
+
+/**
+ *	Dead zone and lag the camera follows the hero with
+ */
+USTRUCT()
+struct FCameraFraming
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere) FDeadFollowZone DeadFollowZone;
+	UPROPERTY(EditAnywhere) float FollowLagSpeed = 6.f;
+
+	void Blend(const FCameraFraming& Other, float Alpha);
+};
+
+/**
+ *	Overrides the camera framing inside its bounds on the XZ play plane and fades it out over the blend distance.
+ *	Volumes are registered once on begin play, moving them at runtime is not supported
+ */
+UCLASS()
+class ARIA_API ACameraBoundsVolume : public AVolume
+{
+	GENERATED_BODY()
+
+public:
+	ACameraBoundsVolume();
+
+	UPROPERTY(EditAnywhere, Category="Camera") FCameraFraming Framing;
+	// higher priorities are blended over lower ones
+	UPROPERTY(EditAnywhere, Category="Camera") int32 Priority = 0;
+	UPROPERTY(EditAnywhere, Category="Camera", meta=(ClampMin=0)) float BlendDistance = 200.f;
+	UPROPERTY(EditAnywhere, Category="Camera") bool bClampCamera = false;
+	UPROPERTY(EditAnywhere, Category="Camera", meta=(EditCondition="bClampCamera")) FVector2D ClampPadding = FVector2D::ZeroVector;
+
+	FBox2D GetPlaneBounds() const;
+	FBox2D GetClampBounds() const;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,27 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Volume.h"
+#include "Interactable/AriaPhysicalMaterial.h"
+#include "TraversalVolume.generated.h"
+
+/**
+ *	Marks the area around ladders, ropes and ice so the movement component only looks for them while inside
+ */
+UCLASS()
+class ARIA_API ATraversalVolume : public AVolume
+{
+	GENERATED_BODY()
+
+public:
+	ATraversalVolume();
+
+	UPROPERTY(EditAnywhere, Category="Traversal", meta=(Bitmask, BitmaskEnum="/Script/Aria.EAriaSurfaceKind")) int32 SurfaceKinds = 0;
+
+protected:
+	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
+	virtual void NotifyActorEndOverlap(AActor* OtherActor) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
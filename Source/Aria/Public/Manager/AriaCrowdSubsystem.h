@@ -0,0 +1,49 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AriaCrowdSubsystem.generated.h"
+
+class AAriaCharacter;
+class UAriaCrowdTraversalProcessor;
+
+/**
+ *	Owns the crowd runner entities and moves them once per frame with the crowd traversal processor
+ */
+UCLASS()
+class ARIA_API UAriaCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 *	Spawns one runner per location with the traversal tuning of the character class
+	 */
+	void SpawnRunners(const TSubclassOf<AAriaCharacter> CharacterClass, TConstArrayView<FVector> Locations, const float Direction, TArray<FMassEntityHandle>& OutRunners);
+	void DestroyRunners(TConstArrayView<FMassEntityHandle> Runners);
+	void GetRunnerLocations(TConstArrayView<FMassEntityHandle> Runners, TArray<FVector>& OutLocations) const;
+
+	/**
+	 *	Slide intent of the runners, like the hero holding the slide input
+	 */
+	void SetWantsToSlide(TConstArrayView<FMassEntityHandle> Runners, bool bWantsToSlide);
+	int32 GetRunnerCount() const { return RunnerCount; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY(Transient) TObjectPtr<UAriaCrowdTraversalProcessor> TraversalProcessor;
+	FMassArchetypeHandle RunnerArchetype;
+	int32 RunnerCount = 0;
+
+	FMassEntityManager* GetEntityManager() const;
+};
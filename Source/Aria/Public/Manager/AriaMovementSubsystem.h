@@ -0,0 +1,95 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "Character/AriaCharacterMovement.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AriaMovementSubsystem.generated.h"
+
+class UAriaCharacterMovement;
+class UAriaMovementSubsystem;
+
+/**
+ *	Ticks every batched Aria movement component in one pass during the pre physics group
+ */
+USTRUCT()
+struct FAriaMovementBatchTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UAriaMovementSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FAriaMovementBatchTickFunction> : TStructOpsTypeTraitsBase2<FAriaMovementBatchTickFunction>
+{
+	enum
+	{
+		WithCopy = false,
+	};
+};
+
+/**
+ *	Owns every Aria movement component in the world. Assigns their LOD tier from the distance to the nearest viewer and their visibility,
+ *	and ticks them in one batch: the transition probes of all due characters are traced in parallel on the worker threads before the moves are applied
+ */
+UCLASS()
+class ARIA_API UAriaMovementSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterMovement(UAriaCharacterMovement* Movement);
+	void UnregisterMovement(UAriaCharacterMovement* Movement);
+	void TickBatch(float DeltaTime, ELevelTick TickType);
+	void AddBatchTickDependent(FTickFunction& TickFunction);
+	void RemoveBatchTickDependent(FTickFunction& TickFunction);
+
+	// Scene Query Budget
+	void AddSceneQuery() { WorldSceneQueryCount.fetch_add(1, std::memory_order_relaxed); }
+	int32 GetWorldSceneQueryShare() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY(Transient) TArray<TObjectPtr<UAriaCharacterMovement>> Movements;
+
+	// LOD
+	static constexpr float LodUpdateInterval = .25f;
+	float LodUpdateTime = 0.f;
+	void UpdateMovementLods();
+
+	// Batched Tick
+	FAriaMovementBatchTickFunction BatchTickFunction;
+	TArray<float> PendingTickTimes;
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> MovementBases;
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, int32> BaseReferences;
+	TArray<TPair<TWeakObjectPtr<UAriaCharacterMovement>, float>> DueMovements;
+	bool bBatchedTickEnabled = false;
+	bool IsBatchedTickEnabled() const;
+	void ApplyBatchedTick();
+	void SetMovementBatched(int32 Index, bool bBatched);
+	void UpdateBaseTickDependency(int32 Index);
+	bool IsBatchedCharacterBase(const UPrimitiveComponent* Base) const;
+
+	// Probe Batch
+	TArray<UAriaCharacterMovement*> ProbeMovements;
+	TArray<FAriaProbeRequest> ProbeRequests;
+	TArray<FAriaProbeResult> ProbeResults;
+	void ProbeBatch();
+
+	// Scene Query Budget
+	std::atomic<int32> WorldSceneQueryCount = 0;
+};
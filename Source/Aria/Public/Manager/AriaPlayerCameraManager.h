@@ -4,34 +4,31 @@
 
 #include "CoreMinimal.h"
 #include "Camera/PlayerCameraManager.h"
+#include "Manager/CameraBoundsSubsystem.h"
 #include "AriaPlayerCameraManager.generated.h"
 
-class AAriaCharacter;
+class UAriaCharacterMovement;
+struct FAriaCameraSnapshot;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogAriaCameraManager, Log, All);
 
-USTRUCT()
-struct FDeadFollowZone
-{
-	GENERATED_BODY()
-
-	UPROPERTY(EditDefaultsOnly) bool bEnabled = true;
-	UPROPERTY(EditDefaultsOnly) float LeftOffset = 100.f;
-	UPROPERTY(EditDefaultsOnly) float RightOffset = 100.f;
-	UPROPERTY(EditDefaultsOnly) float TopOffset = 100.f;
-};
-
 UCLASS()
 class ARIA_API AAriaPlayerCameraManager : public APlayerCameraManager
 {
 	GENERATED_BODY()
 
+public:
+	static FVector GetFollowLocation(const FCameraFraming& Framing, const FAriaCameraSnapshot& Snapshot, const FVector& CameraLocation, const FVector& ViewTargetLocation);
+
 protected:
-	virtual void BeginPlay() override;
 	virtual void UpdateViewTarget(FTViewTarget& OutVT, float DeltaTime) override;
 
 private:
-	UPROPERTY(Transient) TObjectPtr<AAriaCharacter> AriaCharacterOwner;
+	UPROPERTY(Transient) TObjectPtr<UAriaCharacterMovement> FollowedMovement;
+	const UAriaCharacterMovement* ResolveFollowedMovement(const FTViewTarget& VT);
+
+	// Late Update
+	UPROPERTY(EditDefaultsOnly, Category="Camera") bool bLateUpdateFollow = true;
 
 	// Camera Lag
 	UPROPERTY(EditDefaultsOnly, Category="Camera|Lag") bool bEnableFollowLag = true;
@@ -39,8 +36,14 @@ private:
 
 	// Dead Zone
 	UPROPERTY(EditDefaultsOnly, Category="Camera") FDeadFollowZone DeadFollowZone;
-	float GetFollowTargetX(const FVector& TargetLocation, const FVector& CameraLocation) const;
-	float GetFollowTargetZ(const FVector& TargetLocation, const FVector& CameraLocation, const FVector& ViewTargetLocation) const;
+	static float GetFollowTargetX(const FDeadFollowZone& DeadZone, const FVector& TargetLocation, const FVector& CameraLocation);
+	static float GetFollowTargetZ(const FDeadFollowZone& DeadZone, const FAriaCameraSnapshot& Snapshot, const FVector& CameraLocation, const FVector& ViewTargetLocation);
+
+	// Camera Bounds
+	UPROPERTY(Transient) TObjectPtr<UCameraBoundsSubsystem> CameraBoundsSubsystem;
+	FCameraBoundsBlend CameraBoundsBlend;
+	void BlendCameraBounds(const FVector& TargetLocation);
+	FVector ClampToCameraBounds(const FVector& CameraLocation) const;
 	
-	void FollowCharacter(FTViewTarget& OutVT, float DeltaTime);
+	void FollowCharacter(const FAriaCameraSnapshot& Snapshot, float DeltaTime);
 };
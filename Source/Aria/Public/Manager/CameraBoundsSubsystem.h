@@ -0,0 +1,59 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interactable/CameraBoundsVolume.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CameraBoundsSubsystem.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogCameraBounds, Log, All);
+
+/**
+ *	Framing blended from every camera bounds volume around a location, with the clamp boxes to apply and their weights
+ */
+struct FCameraBoundsBlend
+{
+	FCameraFraming Framing;
+	TArray<TPair<FBox2D, float>, TInlineAllocator<4>> Clamps;
+};
+
+/**
+ *	Indexes the camera bounds volumes of the world in a uniform grid on the XZ play plane,
+ *	so finding the volumes around the hero only reads the one cell it stands in
+ */
+UCLASS()
+class ARIA_API UCameraBoundsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Register(const ACameraBoundsVolume* Volume);
+	void Unregister(const ACameraBoundsVolume* Volume);
+	void Evaluate(const FVector& Location, FCameraBoundsBlend& InOutBlend) const;
+	int32 Num() const { return Entries.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<const ACameraBoundsVolume> Volume;
+		FBox2D Bounds;
+		FBox2D ClampBounds;
+		FCameraFraming Framing;
+		float BlendDistance = 0.f;
+		int32 Priority = 0;
+		bool bClampCamera = false;
+	};
+
+	static constexpr float CellSize = 2048.f;
+
+	TSparseArray<FEntry> Entries;
+	TMap<FIntPoint, TArray<int32, TInlineAllocator<4>>> Cells;
+
+	static FIntPoint ToCell(const FVector2D& Location);
+	static float GetWeight(const FEntry& Entry, const FVector2D& Location);
+	void ForEachCell(const FEntry& Entry, TFunctionRef<void(const FIntPoint&)> Callback) const;
+};
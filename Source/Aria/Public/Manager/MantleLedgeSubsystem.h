@@ -0,0 +1,37 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Utils/MantleLedgeDatabase.h"
+#include "MantleLedgeSubsystem.generated.h"
+
+struct FAriaMantleLedge;
+struct FAriaMantleQuery;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogMantleLedges, Log, All);
+
+/**
+ *	Serves mantle ledges baked offline for the current level. Levels without a baked file fall back to runtime probes
+ */
+UCLASS()
+class ARIA_API UMantleLedgeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	bool HasLedges() const { return Database.IsLoaded(); }
+	bool FindLedge(const FVector& FrontStart, const FVector& ForwardVector, float CheckDistance, float CapsuleRadius, const FAriaMantleQuery& Query, FAriaMantleLedge& OutLedge) const;
+
+	static FString GetLedgeFilename(const FString& MapPackageName);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	FMantleLedgeDatabase Database;
+};
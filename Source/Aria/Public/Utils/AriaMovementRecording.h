@@ -0,0 +1,92 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+class IFileHandle;
+
+/**
+ *	Where and how a recorded character started
+ */
+struct FAriaMovementRecordHeader
+{
+	FString MapName;
+	FString CharacterClass;
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	FVector Velocity = FVector::ZeroVector;
+	uint8 MovementMode = 0;
+	uint8 CustomMovementMode = 0;
+
+	// traversal state the mode alone doesn't carry
+	float SlidingTime = 0.f;
+	bool bIsDashInProgress = false;
+	float DashCooldownRemaining = 0.f;
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+
+	friend FArchive& operator<<(FArchive& Ar, FAriaMovementRecordHeader& Header);
+};
+
+/**
+ *	One movement tick: the input it consumed and the state it produced
+ */
+struct FAriaMovementRecordFrame
+{
+	enum EIntent : uint8
+	{
+		Move = 1 << 0,
+		Slide = 1 << 1,
+		Crawl = 1 << 2,
+		Dash = 1 << 3,
+		Jump = 1 << 4,
+		Crouch = 1 << 5,
+	};
+
+	// input
+	float DeltaTime = 0.f;
+	FVector3f InputVector = FVector3f::ZeroVector;
+	uint8 Intents = 0;
+
+	// result
+	uint8 MovementMode = 0;
+	uint8 CustomMovementMode = 0;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+};
+
+/**
+ *	Appends delta encoded frames to a recording. Full blocks are written to disk on a worker thread
+ */
+class ARIA_API FAriaMovementRecordWriter
+{
+public:
+	~FAriaMovementRecordWriter();
+
+	bool Open(const FString& Filename, const FAriaMovementRecordHeader& Header);
+	void AddFrame(const FAriaMovementRecordFrame& Frame);
+	void Close();
+	int32 NumFrames() const { return FrameCount; }
+
+private:
+	static constexpr int32 FlushSize = 64 * 1024;
+
+	TUniquePtr<IFileHandle> FileHandle;
+	TArray<uint8> Buffer;
+	TFuture<void> PendingFlush;
+	FAriaMovementRecordFrame LastFrame;
+	int32 FrameCount = 0;
+
+	void Flush();
+};
+
+/**
+ *	Decodes a whole recording
+ */
+class ARIA_API FAriaMovementRecordReader
+{
+public:
+	static bool Load(const FString& Filename, FAriaMovementRecordHeader& OutHeader, TArray<FAriaMovementRecordFrame>& OutFrames);
+};
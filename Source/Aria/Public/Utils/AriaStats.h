@@ -0,0 +1,26 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+DECLARE_STATS_GROUP(TEXT("AriaMovement"), STATGROUP_AriaMovement, STATCAT_Advanced);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(ARIA_API, AriaMovement);
+UE_TRACE_CHANNEL_EXTERN(AriaMovementChannel, ARIA_API);
+
+/**
+ *	Times the enclosing scope for `stat AriaMovement` and for Insights when the AriaMovement trace channel is on.
+ *	The cycle stat has to be declared with DECLARE_CYCLE_STAT(TEXT("..."), STAT_Aria<Name>, STATGROUP_AriaMovement)
+ */
+#define ARIA_MOVEMENT_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_Aria##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Aria##Name, AriaMovementChannel)
+
+/**
+ *	Adds to a per frame counter of the AriaMovement CSV category
+ */
+#define ARIA_MOVEMENT_CSV_COUNT(Name, Count) CSV_CUSTOM_STAT(AriaMovement, Name, Count, ECsvCustomStatOp::Accumulate)
@@ -0,0 +1,73 @@
+// Copyright (c) SPC Gaming. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ *	Ledge baked from level collision. Stored in the grid cell of its surface location on the XZ play plane
+ */
+struct FMantleLedgeRecord
+{
+	FVector3f Surface;
+	FVector3f Target;
+	int8 WallNormal[3];
+	int8 SurfaceNormal[3];
+	uint16 Padding;
+
+	// range of front trace heights from which the ledge was reachable
+	float MinReachZ;
+	float MaxReachZ;
+
+	static void PackNormal(const FVector& Normal, int8 (&OutPacked)[3]);
+	static FVector UnpackNormal(const int8 (&Packed)[3]);
+};
+
+static_assert(sizeof(FMantleLedgeRecord) == 40, "FMantleLedgeRecord is part of the baked file format");
+
+/**
+ *	Read-only ledge database memory-mapped from a baked file and queried through a uniform grid
+ */
+class ARIA_API FMantleLedgeDatabase
+{
+public:
+	FMantleLedgeDatabase();
+	~FMantleLedgeDatabase();
+
+	bool Load(const FString& Filename);
+	void Unload();
+	bool IsLoaded() const { return Header != nullptr; }
+	int32 Num() const;
+	const FMantleLedgeRecord* FindLedge(const FVector& FrontStart, const FVector& ForwardVector, float CheckDistance, float ReachHeight, float MaxAlignmentCos, float LateralTolerance) const;
+
+	static bool Save(const FString& Filename, const TArray<FMantleLedgeRecord>& Records, float CellSize);
+
+private:
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		float CellSize;
+		float OriginX;
+		float OriginZ;
+		int32 GridWidth;
+		int32 GridHeight;
+		int32 NumLedges;
+	};
+
+	static constexpr uint32 FileMagic = 0x4C4D5241; // "ARML"
+	static constexpr uint32 FileVersion = 1;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> FileData;
+
+	const FHeader* Header = nullptr;
+	const uint32* CellStarts = nullptr;
+	const FMantleLedgeRecord* Records = nullptr;
+
+	bool Bind(const uint8* Data, int64 Size);
+};